@@ -0,0 +1,59 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2016 MerryMage
+ * This software may be used and distributed according to the terms of the GNU
+ * General Public License version 2 or any later version.
+ */
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <dynarmic/callbacks.h>
+#include <dynarmic/dynarmic.h>
+
+#include "common/common_types.h"
+
+namespace Bench {
+
+// Guest address space layout
+// All guest memory below GUEST_MEMORY_SIZE is mapped through the page table. Everything above
+// MMIO_BASE is only reachable through the memory callbacks.
+constexpr u32 CODE_BASE = 0x00000000;
+constexpr u32 DATA_BASE = 0x00010000;
+constexpr u32 STACK_TOP = 0x00100000;
+constexpr u32 GUEST_MEMORY_SIZE = 0x00400000;
+constexpr u32 MMIO_BASE = 0xF0000000;
+
+/// Writes to guest memory, for use by Workload::setup.
+void Write32(u32 vaddr, u32 value);
+void WriteFloat(u32 vaddr, float value);
+
+struct Workload {
+    enum class Kind {
+        /// Measures the execution of guest code, once all of it has been compiled.
+        Execute,
+        /// Measures compilation, by repeatedly clearing the cache and compiling a single block.
+        /// Only the compilation stages are timed; guest_instructions counts translated instructions.
+        Translate,
+    };
+
+    std::string name;
+    Kind kind;
+    bool thumb;
+    /// Loaded at CODE_BASE. Execution starts at CODE_BASE.
+    std::vector<u32> code;
+    /// Initializes guest registers and memory. Optional.
+    std::function<void(Dynarmic::Jit&)> setup;
+    /// Modifies the configuration of the JIT, e.g.: to compare implementation variants. Optional.
+    std::function<void(Dynarmic::UserCallbacks&)> configure;
+};
+
+/// Packs Thumb halfwords into words, in memory order.
+std::vector<u32> ThumbCode(std::initializer_list<u16> halfwords);
+
+std::vector<Workload> GetWorkloads();
+
+} // namespace Bench
@@ -0,0 +1,329 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2016 MerryMage
+ * This software may be used and distributed according to the terms of the GNU
+ * General Public License version 2 or any later version.
+ */
+
+/**
+ * Runs each synthetic guest workload (See: workloads.cpp) and writes one JSON object per line to
+ * stdout, so that results can be compared across commits.
+ *
+ * Usage: dynarmic_bench [--filter=<substring>] [--cycles=<n>] [--iterations=<n>] [--list]
+ *
+ * --filter restricts the run to workloads whose name contains the substring. This is also useful
+ * for collecting hardware counters for a single workload, e.g.:
+ *     perf stat -e cache-misses,cache-references dynarmic_bench --filter=arm_integer_loop
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <dynarmic/dynarmic.h>
+
+#include "bench.h"
+#include "common/common_types.h"
+
+// Every heap allocation made by the process is counted, to measure the allocations made per compiled block.
+static std::atomic<u64> allocation_count{0};
+
+void* operator new(std::size_t size) {
+    allocation_count++;
+    if (void* ptr = std::malloc(size != 0 ? size : 1))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace Bench {
+
+using PageTable = std::array<u8*, Dynarmic::UserCallbacks::NUM_PAGE_TABLE_ENTRIES>;
+
+static std::vector<u8> guest_memory(GUEST_MEMORY_SIZE);
+static std::unique_ptr<PageTable> page_table = std::make_unique<PageTable>();
+static u64 callback_count = 0;
+
+void Write32(u32 vaddr, u32 value) {
+    std::memcpy(&guest_memory[vaddr], &value, sizeof(value));
+}
+
+void WriteFloat(u32 vaddr, float value) {
+    std::memcpy(&guest_memory[vaddr], &value, sizeof(value));
+}
+
+// The memory callbacks are only used for translation, for accesses that straddle a page boundary
+// and for MMIO, i.e.: anything at or above GUEST_MEMORY_SIZE.
+template <typename T>
+static T MemoryRead(u32 vaddr) {
+    callback_count++;
+    if (vaddr <= GUEST_MEMORY_SIZE - sizeof(T)) {
+        T value;
+        std::memcpy(&value, &guest_memory[vaddr], sizeof(T));
+        return value;
+    }
+    return static_cast<T>(vaddr);
+}
+
+template <typename T>
+static void MemoryWrite(u32 vaddr, T value) {
+    callback_count++;
+    if (vaddr <= GUEST_MEMORY_SIZE - sizeof(T)) {
+        std::memcpy(&guest_memory[vaddr], &value, sizeof(T));
+    }
+}
+
+static bool IsReadOnlyMemory(u32) {
+    return false;
+}
+
+static void InterpreterFallback(u32 pc, Dynarmic::Jit*, void*) {
+    std::fprintf(stderr, "Unexpected interpreter fallback at pc %08x\n", pc);
+    std::abort();
+}
+
+static void CallSVC(u32) {
+    callback_count++;
+}
+
+static Dynarmic::UserCallbacks GetUserCallbacks() {
+    Dynarmic::UserCallbacks user_callbacks{};
+    user_callbacks.MemoryRead8 = &MemoryRead<u8>;
+    user_callbacks.MemoryRead16 = &MemoryRead<u16>;
+    user_callbacks.MemoryRead32 = &MemoryRead<u32>;
+    user_callbacks.MemoryRead64 = &MemoryRead<u64>;
+    user_callbacks.MemoryWrite8 = &MemoryWrite<u8>;
+    user_callbacks.MemoryWrite16 = &MemoryWrite<u16>;
+    user_callbacks.MemoryWrite32 = &MemoryWrite<u32>;
+    user_callbacks.MemoryWrite64 = &MemoryWrite<u64>;
+    user_callbacks.IsReadOnlyMemory = &IsReadOnlyMemory;
+    user_callbacks.InterpreterFallback = &InterpreterFallback;
+    user_callbacks.CallSVC = &CallSVC;
+    user_callbacks.page_table = page_table.get();
+    return user_callbacks;
+}
+
+static void ResetGuestMemory(const Workload& workload) {
+    std::fill(guest_memory.begin(), guest_memory.end(), 0);
+    for (size_t i = 0; i < workload.code.size(); i++) {
+        Write32(static_cast<u32>(CODE_BASE + i * 4), workload.code[i]);
+    }
+
+    page_table->fill(nullptr);
+    for (u32 vaddr = 0; vaddr < GUEST_MEMORY_SIZE; vaddr += 1 << Dynarmic::UserCallbacks::PAGE_BITS) {
+        (*page_table)[vaddr >> Dynarmic::UserCallbacks::PAGE_BITS] = &guest_memory[vaddr];
+    }
+}
+
+static long PeakResidentSetKiB() {
+#if defined(__APPLE__)
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+#elif defined(__unix__)
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+/// Accumulates the fields of a single-line JSON object.
+class JsonLine {
+public:
+    template <typename T>
+    JsonLine& Add(const std::string& key, const T& value) {
+        Key(key);
+        stream << value;
+        return *this;
+    }
+
+    JsonLine& Add(const std::string& key, const std::string& value) {
+        Key(key);
+        stream << '"' << value << '"';
+        return *this;
+    }
+
+    JsonLine& Add(const std::string& key, const JsonLine& object) {
+        Key(key);
+        stream << object.Str();
+        return *this;
+    }
+
+    std::string Str() const {
+        return "{" + stream.str() + "}";
+    }
+
+private:
+    void Key(const std::string& key) {
+        if (!first)
+            stream << ',';
+        first = false;
+        stream << '"' << key << "\":";
+    }
+
+    bool first = true;
+    std::ostringstream stream;
+};
+
+struct Options {
+    std::string filter;
+    u64 cycles = 100000000;
+    size_t iterations = 100;
+    bool list = false;
+};
+
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static JsonLine RunWorkload(const Workload& workload, const Options& options) {
+    ResetGuestMemory(workload);
+
+    Dynarmic::UserCallbacks user_callbacks = GetUserCallbacks();
+    if (workload.configure)
+        workload.configure(user_callbacks);
+
+    Dynarmic::Jit jit{user_callbacks};
+    jit.Regs()[13] = STACK_TOP;
+    jit.Regs()[15] = CODE_BASE;
+    jit.Cpsr() = workload.thumb ? 0x000001F0 : 0x000001D0; // User-mode
+    if (workload.setup)
+        workload.setup(jit);
+
+    callback_count = 0;
+    const u64 allocations_before = allocation_count;
+
+    u64 guest_instructions = 0;
+    double seconds = 0;
+    switch (workload.kind) {
+    case Workload::Kind::Execute: {
+        // Compile every block of the workload before timing.
+        jit.Run(100000);
+
+        callback_count = 0;
+        const auto start = std::chrono::steady_clock::now();
+        // Every guest instruction costs a single cycle.
+        guest_instructions = jit.Run(options.cycles);
+        seconds = SecondsSince(start);
+        break;
+    }
+    case Workload::Kind::Translate: {
+        // Running the block is needed to compile it, but it is not timed: only the compilation
+        // stages are (See: Jit::GetStatistics).
+        for (size_t i = 0; i < options.iterations; i++) {
+            jit.ClearCache();
+            jit.Regs()[15] = CODE_BASE;
+            jit.Run(1);
+        }
+        break;
+    }
+    }
+
+    const u64 allocations = allocation_count - allocations_before;
+    const Dynarmic::Statistics statistics = jit.GetStatistics();
+
+    u64 translation_nanoseconds = 0;
+    JsonLine stages;
+    for (const auto& stage : statistics.stages) {
+        translation_nanoseconds += stage.nanoseconds;
+        stages.Add(stage.name, JsonLine{}
+                .Add("nanoseconds", stage.nanoseconds)
+                .Add("ir_instructions_before", stage.ir_instructions_before)
+                .Add("ir_instructions_after", stage.ir_instructions_after));
+    }
+    const double translation_seconds = translation_nanoseconds / 1e9;
+
+    JsonLine result;
+    result.Add("benchmark", workload.name)
+          .Add("isa", std::string(workload.thumb ? "thumb" : "arm"));
+    switch (workload.kind) {
+    case Workload::Kind::Execute:
+        result.Add("guest_instructions", guest_instructions)
+              .Add("seconds", seconds)
+              .Add("guest_mips", seconds > 0 ? guest_instructions / seconds / 1e6 : 0.0);
+        break;
+    case Workload::Kind::Translate:
+        result.Add("guest_instructions", statistics.guest_instructions_translated)
+              .Add("seconds", translation_seconds);
+        break;
+    }
+    result.Add("blocks_compiled", statistics.blocks_compiled)
+          .Add("guest_instructions_translated", statistics.guest_instructions_translated)
+          .Add("translation_seconds", translation_seconds)
+          .Add("translated_instructions_per_second", translation_seconds > 0 ? statistics.guest_instructions_translated / translation_seconds : 0.0)
+          .Add("host_code_bytes", statistics.host_code_bytes_emitted)
+          .Add("allocations_per_block", statistics.blocks_compiled > 0 ? static_cast<double>(allocations) / statistics.blocks_compiled : 0.0)
+          .Add("dispatcher_entries", statistics.dispatcher_entries)
+          .Add("dispatcher_exits", statistics.dispatcher_exits)
+          .Add("rsb_hits", statistics.rsb_hits)
+          .Add("rsb_misses", statistics.rsb_misses)
+          .Add("callbacks", callback_count)
+          .Add("peak_rss_kib", PeakResidentSetKiB())
+          .Add("stages", stages);
+    return result;
+}
+
+static bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const auto value_of = [&arg](const std::string& prefix) { return arg.substr(prefix.size()); };
+
+        if (arg.compare(0, 9, "--filter=") == 0) {
+            options.filter = value_of("--filter=");
+        } else if (arg.compare(0, 9, "--cycles=") == 0) {
+            options.cycles = std::strtoull(value_of("--cycles=").c_str(), nullptr, 10);
+        } else if (arg.compare(0, 13, "--iterations=") == 0) {
+            options.iterations = std::strtoull(value_of("--iterations=").c_str(), nullptr, 10);
+        } else if (arg == "--list") {
+            options.list = true;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--filter=<substring>] [--cycles=<n>] [--iterations=<n>] [--list]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Bench
+
+int main(int argc, char** argv) {
+    Bench::Options options;
+    if (!Bench::ParseOptions(argc, argv, options))
+        return 1;
+
+    for (const auto& workload : Bench::GetWorkloads()) {
+        if (workload.name.find(options.filter) == std::string::npos)
+            continue;
+
+        if (options.list) {
+            std::cout << workload.name << std::endl;
+            continue;
+        }
+
+        std::cout << Bench::RunWorkload(workload, options).Str() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,309 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2016 MerryMage
+ * This software may be used and distributed according to the terms of the GNU
+ * General Public License version 2 or any later version.
+ */
+
+#include <cstring>
+
+#include "bench.h"
+
+namespace Bench {
+
+static u32 FloatBits(float value) {
+    u32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void SetSingle(Dynarmic::Jit& jit, size_t index, float value) {
+    jit.ExtRegs()[index] = FloatBits(value);
+}
+
+static void SetDouble(Dynarmic::Jit& jit, size_t index, double value) {
+    u64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    jit.ExtRegs()[index * 2] = static_cast<u32>(bits);
+    jit.ExtRegs()[index * 2 + 1] = static_cast<u32>(bits >> 32);
+}
+
+std::vector<u32> ThumbCode(std::initializer_list<u16> halfwords) {
+    std::vector<u32> code((halfwords.size() + 1) / 2);
+    size_t i = 0;
+    for (u16 halfword : halfwords) {
+        code[i / 2] |= u32(halfword) << (i % 2 * 16);
+        i++;
+    }
+    return code;
+}
+
+/**
+ * A single basic block of `length` instructions, mixing data processing, multiplies and memory
+ * accesses over many registers. Used to measure the throughput of translation, the optimization
+ * passes and register allocation.
+ */
+static std::vector<u32> LargeBlock(size_t length) {
+    std::vector<u32> code;
+    for (size_t i = 0; i + 1 < length; i++) {
+        const u32 d = i % 12;
+        const u32 n = (i * 5 + 1) % 12;
+        const u32 m = (i * 7 + 3) % 12;
+        const u32 offset = (i * 4) % 1024;
+        switch (i % 8) {
+        case 0: code.push_back(0xE0800000 | n << 16 | d << 12 | m); break;                  // add rd, rn, rm
+        case 1: code.push_back(0xE0200000 | n << 16 | d << 12 | m); break;                  // eor rd, rn, rm
+        case 2: code.push_back(0xE1800000 | n << 16 | d << 12 | (i % 31 + 1) << 7 | m); break; // orr rd, rn, rm, lsl #imm
+        case 3: code.push_back(0xE2500000 | n << 16 | d << 12 | (i % 256)); break;         // subs rd, rn, #imm
+        case 4: code.push_back(0xE59C0000 | d << 12 | offset); break;                       // ldr rd, [r12, #offset]
+        case 5: code.push_back(0xE0000090 | d << 16 | n << 8 | m); break;                   // mul rd, rm, rn
+        case 6: code.push_back(0xE0A00000 | n << 16 | d << 12 | m); break;                  // adc rd, rn, rm
+        case 7: code.push_back(0xE58C0000 | d << 12 | offset); break;                       // str rd, [r12, #offset]
+        }
+    }
+    const s32 branch_offset = -static_cast<s32>(code.size() * 4 + 8);
+    code.push_back(0xEA000000 | ((branch_offset >> 2) & 0xFFFFFF));                         // b start
+    return code;
+}
+
+std::vector<Workload> GetWorkloads() {
+    using Kind = Workload::Kind;
+
+    std::vector<Workload> workloads;
+
+    workloads.push_back({"arm_integer_loop", Kind::Execute, false, {
+        0xE0811000, // loop: add r1, r1, r0
+        0xE0222181, //       eor r2, r2, r1, lsl #3
+        0xE2500001, //       subs r0, r0, #1
+        0x1AFFFFFB, //       bne loop
+        0xE3A00FFA, //       mov r0, #1000
+        0xEAFFFFF9, //       b loop
+    }, [](Dynarmic::Jit& jit) {
+        jit.Regs()[0] = 1000;
+    }, {}});
+
+    workloads.push_back({"thumb_integer_loop", Kind::Execute, true, ThumbCode({
+        0x1809, // loop: adds r1, r1, r0
+        0x404A, //       eors r2, r1
+        0x3801, //       subs r0, #1
+        0xD1FB, //       bne loop
+        0x20FF, //       movs r0, #255
+        0xE7F9, //       b loop
+    }), [](Dynarmic::Jit& jit) {
+        jit.Regs()[0] = 255;
+    }, {}});
+
+    workloads.push_back({"arm_call_return", Kind::Execute, false, {
+        0xE3A00010, // main:    mov r0, #16
+        0xEB000001, //          bl recurse
+        0xEAFFFFFC, //          b main
+        0xE1A00000, //          mov r0, r0
+        0xE92D4001, // recurse: push {r0, lr}
+        0xE2500001, //          subs r0, r0, #1
+        0x1BFFFFFC, //          blne recurse
+        0xE8BD8001, //          pop {r0, pc}
+    }, {}, {}});
+
+    workloads.push_back({"thumb_call_return", Kind::Execute, true, ThumbCode({
+        0x2010,         // main:    movs r0, #16
+        0xF000, 0xF802, //          bl recurse
+        0xE7FB,         //          b main
+        0x0000,         //          movs r0, r0
+        0xB501,         // recurse: push {r0, lr}
+        0x3801,         //          subs r0, #1
+        0xD001,         //          beq return
+        0xF7FF, 0xFFFB, //          bl recurse
+        0xBD01,         // return:  pop {r0, pc}
+    }), {}, {}});
+
+    workloads.push_back({"arm_indirect_branch", Kind::Execute, false, {
+        0xE2001003, // dispatch: and r1, r0, #3
+        0xE2800001, //           add r0, r0, #1
+        0xE792F101, //           ldr pc, [r2, r1, lsl #2]
+        0xE1A00000, //           mov r0, r0
+        0xE2833001, // case0:    add r3, r3, #1
+        0xEAFFFFF9, //           b dispatch
+        0xE2433001, // case1:    sub r3, r3, #1
+        0xEAFFFFF7, //           b dispatch
+        0xE0233000, // case2:    eor r3, r3, r0
+        0xEAFFFFF5, //           b dispatch
+        0xE1A030E3, // case3:    mov r3, r3, ror #1
+        0xEAFFFFF3, //           b dispatch
+    }, [](Dynarmic::Jit& jit) {
+        // Jump table
+        for (u32 i = 0; i < 4; i++) {
+            Write32(DATA_BASE + i * 4, CODE_BASE + 0x10 + i * 8);
+        }
+        jit.Regs()[2] = DATA_BASE;
+    }, {}});
+
+    workloads.push_back({"arm_memcpy_words", Kind::Execute, false, {
+        0xE8B000F0, // copy: ldmia r0!, {r4-r7}
+        0xE8A100F0, //       stmia r1!, {r4-r7}
+        0xE2522001, //       subs r2, r2, #1
+        0x1AFFFFFB, //       bne copy
+        0xE2400A01, //       sub r0, r0, #0x1000
+        0xE2411A01, //       sub r1, r1, #0x1000
+        0xE3A02C01, //       mov r2, #0x100
+        0xEAFFFFF7, //       b copy
+    }, [](Dynarmic::Jit& jit) {
+        jit.Regs()[0] = DATA_BASE;
+        jit.Regs()[1] = DATA_BASE + 0x10000;
+        jit.Regs()[2] = 0x100;
+    }, {}});
+
+    workloads.push_back({"arm_memcpy_bytes", Kind::Execute, false, {
+        0xE4D03001, // copy: ldrb r3, [r0], #1
+        0xE4C13001, //       strb r3, [r1], #1
+        0xE2522001, //       subs r2, r2, #1
+        0x1AFFFFFB, //       bne copy
+        0xE2400A01, //       sub r0, r0, #0x1000
+        0xE2411A01, //       sub r1, r1, #0x1000
+        0xE3A02A01, //       mov r2, #0x1000
+        0xEAFFFFF7, //       b copy
+    }, [](Dynarmic::Jit& jit) {
+        jit.Regs()[0] = DATA_BASE;
+        jit.Regs()[1] = DATA_BASE + 0x10000;
+        jit.Regs()[2] = 0x1000;
+    }, {}});
+
+    // Flush-to-zero and default NaN mode, which the accurate FP path emulates and fast_fp does not.
+    constexpr u32 FPSCR_FZ_DN = 0x03000000;
+    const auto fast_fp = [](Dynarmic::UserCallbacks& cb) {
+        cb.fast_fp = true;
+    };
+
+    const std::vector<u32> vfp_saxpy_code {
+        0xEDD00A00, // loop: vldr s1, [r0]
+        0xED911A00, //       vldr s2, [r1]
+        0xEE001A20, //       vmla.f32 s2, s0, s1
+        0xED811A00, //       vstr s2, [r1]
+        0xE2800004, //       add r0, r0, #4
+        0xE2811004, //       add r1, r1, #4
+        0xE2522001, //       subs r2, r2, #1
+        0x1AFFFFF7, //       bne loop
+        0xE2400B01, //       sub r0, r0, #0x400
+        0xE2411B01, //       sub r1, r1, #0x400
+        0xE3A02C01, //       mov r2, #0x100
+        0xEAFFFFF3, //       b loop
+    };
+    const auto vfp_saxpy_setup = [](Dynarmic::Jit& jit) {
+        for (u32 i = 0; i < 0x100; i++) {
+            WriteFloat(DATA_BASE + i * 4, 0.5f * (i % 7));
+        }
+        jit.Regs()[0] = DATA_BASE;
+        jit.Regs()[1] = DATA_BASE + 0x10000;
+        jit.Regs()[2] = 0x100;
+        SetSingle(jit, 0, 1.5f);
+        jit.SetFpscr(FPSCR_FZ_DN);
+    };
+    workloads.push_back({"arm_vfp_saxpy", Kind::Execute, false, vfp_saxpy_code, vfp_saxpy_setup, {}});
+    workloads.push_back({"arm_vfp_saxpy_fast_fp", Kind::Execute, false, vfp_saxpy_code, vfp_saxpy_setup, fast_fp});
+
+    const std::vector<u32> vfp_f64_arithmetic_code {
+        0xEE211B00, // loop: vmul.f64 d1, d1, d0
+        0xEE311B02, //       vadd.f64 d1, d1, d2
+        0xEE843B01, //       vdiv.f64 d3, d4, d1
+        0xEE355B03, //       vadd.f64 d5, d5, d3
+        0xE2500001, //       subs r0, r0, #1
+        0x1AFFFFF9, //       bne loop
+        0xEEB01B42, //       vmov.f64 d1, d2
+        0xE3A00FFA, //       mov r0, #1000
+        0xEAFFFFF6, //       b loop
+    };
+    const auto vfp_f64_arithmetic_setup = [](Dynarmic::Jit& jit) {
+        jit.Regs()[0] = 1000;
+        SetDouble(jit, 0, 0.5);
+        SetDouble(jit, 1, 1.0);
+        SetDouble(jit, 2, 1.0);
+        SetDouble(jit, 4, 1.0);
+        jit.SetFpscr(FPSCR_FZ_DN);
+    };
+    workloads.push_back({"arm_vfp_f64_arithmetic", Kind::Execute, false, vfp_f64_arithmetic_code, vfp_f64_arithmetic_setup, {}});
+    workloads.push_back({"arm_vfp_f64_arithmetic_fast_fp", Kind::Execute, false, vfp_f64_arithmetic_code, vfp_f64_arithmetic_setup, fast_fp});
+
+    // Each conversion is paired with a variant without SSE4.1, which the backend uses for a branchless
+    // saturating conversion.
+    const auto no_sse41 = [](Dynarmic::UserCallbacks& cb) {
+        cb.disabled_host_features = Dynarmic::HostFeature::SSE41;
+    };
+    const auto vfp_convert_f32_setup = [](Dynarmic::Jit& jit) {
+        SetSingle(jit, 2, 0.0f);
+        SetSingle(jit, 3, 0.75f);
+    };
+    const auto vfp_convert_f64_setup = [](Dynarmic::Jit& jit) {
+        SetDouble(jit, 3, 0.0);
+        SetDouble(jit, 4, 0.75);
+    };
+
+    const std::vector<u32> vfp_convert_f32_to_s32_code {
+        0xEEBD2AC1, // loop: vcvt.s32.f32 s4, s2
+        0xEE311A21, //       vadd.f32 s2, s2, s3
+        0xEAFFFFFC, //       b loop
+    };
+    workloads.push_back({"arm_vfp_convert_f32_to_s32", Kind::Execute, false, vfp_convert_f32_to_s32_code, vfp_convert_f32_setup, {}});
+    workloads.push_back({"arm_vfp_convert_f32_to_s32_no_sse41", Kind::Execute, false, vfp_convert_f32_to_s32_code, vfp_convert_f32_setup, no_sse41});
+
+    const std::vector<u32> vfp_convert_f32_to_u32_code {
+        0xEEBC2AC1, // loop: vcvt.u32.f32 s4, s2
+        0xEE311A21, //       vadd.f32 s2, s2, s3
+        0xEAFFFFFC, //       b loop
+    };
+    workloads.push_back({"arm_vfp_convert_f32_to_u32", Kind::Execute, false, vfp_convert_f32_to_u32_code, vfp_convert_f32_setup, {}});
+    workloads.push_back({"arm_vfp_convert_f32_to_u32_no_sse41", Kind::Execute, false, vfp_convert_f32_to_u32_code, vfp_convert_f32_setup, no_sse41});
+
+    const std::vector<u32> vfp_convert_f64_to_s32_code {
+        0xEEBD2BC3, // loop: vcvt.s32.f64 s4, d3
+        0xEE333B04, //       vadd.f64 d3, d3, d4
+        0xEAFFFFFC, //       b loop
+    };
+    workloads.push_back({"arm_vfp_convert_f64_to_s32", Kind::Execute, false, vfp_convert_f64_to_s32_code, vfp_convert_f64_setup, {}});
+    workloads.push_back({"arm_vfp_convert_f64_to_s32_no_sse41", Kind::Execute, false, vfp_convert_f64_to_s32_code, vfp_convert_f64_setup, no_sse41});
+
+    const std::vector<u32> vfp_convert_f64_to_u32_code {
+        0xEEBC2BC3, // loop: vcvt.u32.f64 s4, d3
+        0xEE333B04, //       vadd.f64 d3, d3, d4
+        0xEAFFFFFC, //       b loop
+    };
+    workloads.push_back({"arm_vfp_convert_f64_to_u32", Kind::Execute, false, vfp_convert_f64_to_u32_code, vfp_convert_f64_setup, {}});
+    workloads.push_back({"arm_vfp_convert_f64_to_u32_no_sse41", Kind::Execute, false, vfp_convert_f64_to_u32_code, vfp_convert_f64_setup, no_sse41});
+
+    workloads.push_back({"arm_exclusive_increment", Kind::Execute, false, {
+        0xE1901F9F, // loop: ldrex r1, [r0]
+        0xE2811001, //       add r1, r1, #1
+        0xE1802F91, //       strex r2, r1, [r0]
+        0xE3520000, //       cmp r2, #0
+        0x1AFFFFFA, //       bne loop
+        0xEAFFFFF9, //       b loop
+    }, [](Dynarmic::Jit& jit) {
+        jit.Regs()[0] = DATA_BASE;
+    }, {}});
+
+    workloads.push_back({"arm_mmio_callbacks", Kind::Execute, false, {
+        0xE5901000, // loop: ldr r1, [r0]
+        0xE5801004, //       str r1, [r0, #4]
+        0xE0822001, //       add r2, r2, r1
+        0xEAFFFFFB, //       b loop
+    }, [](Dynarmic::Jit& jit) {
+        jit.Regs()[0] = MMIO_BASE;
+    }, {}});
+
+    const std::vector<u32> svc_code {
+        0xE2800001, // loop: add r0, r0, #1
+        0xEF000000, //       svc #0
+        0xEAFFFFFC, //       b loop
+    };
+    workloads.push_back({"arm_svc", Kind::Execute, false, svc_code, {}, {}});
+    workloads.push_back({"arm_svc_mxcsr_agnostic", Kind::Execute, false, svc_code, {},
+        [](Dynarmic::UserCallbacks& cb) {
+            cb.CallSVC_is_mxcsr_agnostic = true;
+        }});
+
+    workloads.push_back({"arm_translate_large_block", Kind::Translate, false, LargeBlock(2048),
+        [](Dynarmic::Jit& jit) {
+            jit.Regs()[12] = DATA_BASE;
+        }, {}});
+
+    return workloads;
+}
+
+} // namespace Bench
@@ -14,7 +14,26 @@ namespace Dynarmic {
 
 class Jit;
 
-/// These function pointers may be inserted into compiled code.
+/// Optional host instruction set extensions used by the x64 backend (See: UserCallbacks::disabled_host_features).
+namespace HostFeature {
+enum : std::uint32_t {
+    SSSE3 = 1 << 0,
+    AVX   = 1 << 1,
+    BMI2  = 1 << 2,
+    LZCNT = 1 << 3,
+    MOVBE = 1 << 4,
+    SSE41 = 1 << 5,
+};
+} // namespace HostFeature
+
+/**
+ * These function pointers may be inserted into compiled code.
+ *
+ * Except on Windows, a callback may throw an exception. It propagates out of Jit::Run with the host
+ * MXCSR restored. The guest state is then that of partway through the block being executed: the
+ * guest registers may or may not reflect the instructions of the block before the call, and PC may
+ * not have been updated. Set the guest state to resume from before calling Jit::Run again.
+ */
 struct UserCallbacks {
     std::uint8_t (*MemoryRead8)(std::uint32_t vaddr);
     std::uint16_t (*MemoryRead16)(std::uint32_t vaddr);
@@ -34,10 +53,55 @@ struct UserCallbacks {
 
     void (*CallSVC)(std::uint32_t swi);
 
+    // Callbacks that neither execute floating-point code nor depend on the state of the MXCSR
+    // may be tagged as MXCSR-agnostic. They are then called with the guest's MXCSR in effect,
+    // eliding the switch to and from the host's MXCSR around each call.
+    bool InterpreterFallback_is_mxcsr_agnostic = false;
+    bool CallSVC_is_mxcsr_agnostic = false;
+
     // Page Table
+    // Accesses to pages with a null entry, and accesses that straddle a page boundary, use the
+    // memory callbacks above. At most one of page_table and page_directory may be provided.
     static constexpr std::size_t PAGE_BITS = 12;
     static constexpr std::size_t NUM_PAGE_TABLE_ENTRIES = 1 << (32 - PAGE_BITS);
+    /// Flat table of 4K pages.
     std::array<std::uint8_t*, NUM_PAGE_TABLE_ENTRIES>* page_table = nullptr;
+
+    // Sparse Page Table
+    // Each entry of page_directory covers 4MB of the address space, and is either null or points
+    // to a table of (1 << (PAGE_DIRECTORY_SHIFT - page_bits)) page pointers.
+    static constexpr std::size_t PAGE_DIRECTORY_SHIFT = 22;
+    static constexpr std::size_t NUM_PAGE_DIRECTORY_ENTRIES = 1 << (32 - PAGE_DIRECTORY_SHIFT);
+    std::array<std::uint8_t**, NUM_PAGE_DIRECTORY_ENTRIES>* page_directory = nullptr;
+    /// log2 of the page size. Must be PAGE_BITS if page_table is used; page_directory also
+    /// supports larger pages, e.g.: 14 (16K) or 16 (64K).
+    std::size_t page_bits = PAGE_BITS;
+
+    /// Depth of the return stack buffer used to predict the targets of function returns.
+    /// MUST be a power of 2 no greater than 64.
+    std::size_t rsb_size = 8;
+
+    /// Number of times a basic block is interpreted from its intermediate representation before
+    /// host code is emitted for it. Zero emits host code for every block on first execution.
+    std::size_t cold_block_threshold = 0;
+
+    /// Trades floating-point accuracy for speed. FPSCR.FZ is implemented with the host's flush-to-zero
+    /// and denormals-are-zero modes, and FPSCR.DN is ignored; x64 has no equivalent to default NaN
+    /// mode. Denormal inputs and NaN payloads may therefore produce different results than on hardware,
+    /// and FPSCR.IDC is not updated.
+    bool fast_fp = false;
+
+    /// Names emitted code for Linux perf by writing /tmp/perf-<pid>.map. Each basic block is named by
+    /// its guest location, e.g.: dynarmic_arm_00001000_fpscr_00000000. Ignored on other platforms.
+    bool enable_perf_map = false;
+
+    /// Counts the number of times each emitted basic block is executed (See: Jit::GetBlockProfile).
+    /// When disabled, no counting code is emitted.
+    bool enable_block_profiling = false;
+
+    /// HostFeature flags the JIT must not use even if the host supports them.
+    /// This is primarily intended to allow every code path to be tested on a single host.
+    std::uint32_t disabled_host_features = 0;
 };
 
 } // namespace Dynarmic
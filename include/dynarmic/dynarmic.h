@@ -8,8 +8,10 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include <dynarmic/callbacks.h>
 
@@ -19,6 +21,44 @@ namespace IR {
 class LocationDescriptor;
 }
 
+/// Execution statistics of a single emitted basic block (See: Jit::GetBlockProfile).
+struct BlockProfileEntry {
+    std::uint32_t pc;                  ///< Guest address of the first instruction of the block
+    std::uint64_t execution_count;     ///< Number of times the host code of the block has been entered
+    std::size_t host_code_size;        ///< Length in bytes of the emitted host code
+    std::size_t ir_instruction_count;  ///< Number of IR microinstructions after optimization
+};
+
+/// Cumulative statistics of compilation and execution (See: Jit::GetStatistics).
+struct Statistics {
+    /// A stage of compilation: translation of guest code, an optimization pass or emission of host code.
+    /// Decoding of guest instructions is part of the Translate stage.
+    struct Stage {
+        std::string name;
+        std::uint64_t nanoseconds = 0;            ///< Total time spent in this stage
+        std::uint64_t ir_instructions_before = 0; ///< Total number of IR microinstructions input to this stage
+        std::uint64_t ir_instructions_after = 0;  ///< Total number of IR microinstructions output by this stage
+    };
+
+    std::uint64_t blocks_translated = 0;             ///< Basic blocks translated into IR
+    std::uint64_t blocks_compiled = 0;               ///< Basic blocks for which host code has been emitted
+    std::uint64_t guest_instructions_translated = 0;
+    std::vector<Stage> stages;                       ///< In the order in which they are run
+
+    std::uint64_t host_code_bytes_emitted = 0;       ///< Includes code since discarded by Jit::ClearCache
+    std::size_t code_cache_used = 0;                 ///< Bytes of the code cache currently in use
+    std::size_t code_cache_size = 0;
+
+    /// Number of guest instructions translated into interpreter fallbacks (See: UserCallbacks::InterpreterFallback),
+    /// by instruction name.
+    std::map<std::string, std::uint64_t> interpreter_fallbacks;
+
+    std::uint64_t dispatcher_entries = 0; ///< Number of times host code was entered from Jit::Run
+    std::uint64_t dispatcher_exits = 0;   ///< Number of times host code returned to Jit::Run to look up the next block
+    std::uint64_t rsb_hits = 0;           ///< Returns correctly predicted by the return stack buffer
+    std::uint64_t rsb_misses = 0;         ///< Returns not predicted by the return stack buffer
+};
+
 class Jit final {
 public:
     explicit Jit(Dynarmic::UserCallbacks callbacks);
@@ -60,6 +100,17 @@ public:
     std::uint32_t& Cpsr();
     std::uint32_t Cpsr() const;
 
+    /**
+     * Sets CPSR. If the processor mode changes, the mode-specific registers (R8-R14 and SPSR)
+     * of the old mode are banked and those of the new mode are restored.
+     * Jit::Cpsr does not do this.
+     */
+    void SetCpsrWithModeSwitch(std::uint32_t value);
+
+    /// View and modify SPSR of the current mode.
+    std::uint32_t& Spsr();
+    std::uint32_t Spsr() const;
+
     /// View and modify FPSCR.
     std::uint32_t Fpscr() const;
     void SetFpscr(std::uint32_t value) const;
@@ -78,6 +129,21 @@ public:
      */
     std::string Disassemble(const IR::LocationDescriptor& descriptor);
 
+    /**
+     * Requires UserCallbacks::enable_block_profiling, otherwise the result is empty.
+     * Blocks executed by the IR interpreter (See: UserCallbacks::cold_block_threshold) are only counted
+     * once host code has been emitted for them. Counts are discarded when the cache is cleared.
+     * @return Every emitted basic block, hottest first.
+     */
+    std::vector<BlockProfileEntry> GetBlockProfile() const;
+
+    /**
+     * Statistics are accumulated from construction and are not reset by Jit::ClearCache. The RSB
+     * statistics are reset by Jit::Reset.
+     * @return Statistics of compilation and execution.
+     */
+    Statistics GetStatistics() const;
+
 private:
     bool is_executing = false;
 
@@ -119,6 +119,18 @@ void ABI_PopCalleeSaveRegistersAndAdjustStack(Xbyak::CodeGenerator* code, size_t
     ABI_PopRegistersAndAdjustStack(code, frame_size, ABI_ALL_CALLEE_SAVE);
 }
 
+template<typename RegisterArrayT>
+size_t ABI_StackSubtraction(size_t frame_size, const RegisterArrayT& regs) {
+    const size_t num_gprs = std::count_if(regs.begin(), regs.end(), HostLocIsGPR);
+    const size_t num_xmms = std::count_if(regs.begin(), regs.end(), HostLocIsXMM);
+
+    return CalculateFrameInfo(num_gprs, num_xmms, frame_size).stack_subtraction;
+}
+
+size_t ABI_CalleeSaveStackSubtraction(size_t frame_size) {
+    return ABI_StackSubtraction(frame_size, ABI_ALL_CALLEE_SAVE);
+}
+
 void ABI_PushCallerSaveRegistersAndAdjustStack(Xbyak::CodeGenerator* code, size_t frame_size) {
     ABI_PushRegistersAndAdjustStack(code, frame_size, ABI_ALL_CALLER_SAVE);
 }
@@ -127,5 +139,9 @@ void ABI_PopCallerSaveRegistersAndAdjustStack(Xbyak::CodeGenerator* code, size_t
     ABI_PopRegistersAndAdjustStack(code, frame_size, ABI_ALL_CALLER_SAVE);
 }
 
+size_t ABI_CallerSaveStackSubtraction(size_t frame_size) {
+    return ABI_StackSubtraction(frame_size, ABI_ALL_CALLER_SAVE);
+}
+
 } // namespace BackendX64
 } // namespace Dynarmic
@@ -115,5 +115,10 @@ void ABI_PopCalleeSaveRegistersAndAdjustStack(Xbyak::CodeGenerator* code, size_t
 void ABI_PushCallerSaveRegistersAndAdjustStack(Xbyak::CodeGenerator* code, size_t frame_size = 0);
 void ABI_PopCallerSaveRegistersAndAdjustStack(Xbyak::CodeGenerator* code, size_t frame_size = 0);
 
+/// Number of bytes ABI_PushCalleeSaveRegistersAndAdjustStack subtracts from rsp after pushing the callee-save GPRs.
+size_t ABI_CalleeSaveStackSubtraction(size_t frame_size = 0);
+/// Number of bytes ABI_PushCallerSaveRegistersAndAdjustStack subtracts from rsp after pushing the caller-save GPRs.
+size_t ABI_CallerSaveStackSubtraction(size_t frame_size = 0);
+
 } // namespace BackendX64
 } // namespace Dynarmic
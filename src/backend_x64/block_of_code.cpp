@@ -4,14 +4,17 @@
  * General Public License version 2 or any later version.
  */
 
+#include <array>
 #include <cstring>
 #include <limits>
+#include <utility>
 
 #include <xbyak.h>
 
 #include "backend_x64/abi.h"
 #include "backend_x64/block_of_code.h"
 #include "backend_x64/jitstate.h"
+#include "backend_x64/perf_map.h"
 #include "common/assert.h"
 #include "dynarmic/callbacks.h"
 
@@ -20,11 +23,35 @@ namespace BackendX64 {
 
 BlockOfCode::BlockOfCode(UserCallbacks cb) : Xbyak::CodeGenerator(128 * 1024 * 1024), cb(cb) {
     GenConstants();
+    GenMemoryAccessors();
+    // run_code and return_from_run_code are generated directly before the emitted blocks, so that
+    // a single unwind entry describes all of the code which executes within the run_code frame.
     GenRunCode();
     GenReturnFromRunCode();
-    GenMemoryAccessors();
     unwind_handler.Register(this);
     user_code_begin = getCurr<CodePtr>();
+
+    if (cb.enable_perf_map) {
+        // These are emitted back-to-back, so each stub extends up to the start of the next.
+        const std::array<std::pair<CodePtr, const char*>, 12> stubs {{
+            {getCode(), "dynarmic_constants"},
+            {read_memory_8, "dynarmic_read_memory_8"},
+            {read_memory_16, "dynarmic_read_memory_16"},
+            {read_memory_32, "dynarmic_read_memory_32"},
+            {read_memory_64, "dynarmic_read_memory_64"},
+            {write_memory_8, "dynarmic_write_memory_8"},
+            {write_memory_16, "dynarmic_write_memory_16"},
+            {write_memory_32, "dynarmic_write_memory_32"},
+            {write_memory_64, "dynarmic_write_memory_64"},
+            {reinterpret_cast<CodePtr>(run_code), "dynarmic_run_code"},
+            {return_from_run_code, "dynarmic_return_from_run_code"},
+            {user_code_begin, nullptr},
+        }};
+        for (size_t i = 0; i + 1 < stubs.size(); i++) {
+            const size_t size = reinterpret_cast<const u8*>(stubs[i + 1].first) - reinterpret_cast<const u8*>(stubs[i].first);
+            PerfMapRegister(stubs[i].first, size, stubs[i].second);
+        }
+    }
 }
 
 void BlockOfCode::ClearCache() {
@@ -102,80 +129,71 @@ void BlockOfCode::GenRunCode() {
     // 1. It saves all the registers we as a callee need to save.
     // 2. It aligns the stack so that the code the JIT emits can assume
     //    that the stack is appropriately aligned for CALLs.
-    ABI_PushCalleeSaveRegistersAndAdjustStack(this);
+    // It also reserves the spill area, so spill slots are addressed relative to rsp.
+    ABI_PushCalleeSaveRegistersAndAdjustStack(this, SpillFrameSize);
 
     mov(r15, ABI_PARAM1);
-    SwitchMxcsrOnEntry();
+
+    // The page table base is fixed for the lifetime of the JIT, so it is kept in R14 to save
+    // emitted code from having to materialize it on every memory access. Without a page table,
+    // R14 is available to the register allocator instead.
+    if (cb.page_directory) {
+        mov(r14, reinterpret_cast<u64>(cb.page_directory));
+    } else if (cb.page_table) {
+        mov(r14, reinterpret_cast<u64>(cb.page_table));
+    }
+
+    // SwitchMxcsrOnEntry, but ldmxcsr is serializing so we avoid it when the MXCSR would not change.
+    Xbyak::Label mxcsr_unchanged;
+    stmxcsr(dword[r15 + offsetof(JitState, save_host_MXCSR)]);
+    mov(eax, dword[r15 + offsetof(JitState, save_host_MXCSR)]);
+    cmp(eax, dword[r15 + offsetof(JitState, guest_MXCSR)]);
+    je(mxcsr_unchanged);
+    ldmxcsr(dword[r15 + offsetof(JitState, guest_MXCSR)]);
+    L(mxcsr_unchanged);
+
     jmp(ABI_PARAM2);
 }
 
 void BlockOfCode::GenReturnFromRunCode() {
     return_from_run_code = getCurr<const void*>();
 
-    SwitchMxcsrOnExit();
+    // SwitchMxcsrOnExit, with the same elision as in GenRunCode.
+    Xbyak::Label mxcsr_unchanged;
+    stmxcsr(dword[r15 + offsetof(JitState, guest_MXCSR)]);
+    mov(eax, dword[r15 + offsetof(JitState, guest_MXCSR)]);
+    cmp(eax, dword[r15 + offsetof(JitState, save_host_MXCSR)]);
+    je(mxcsr_unchanged);
+    ldmxcsr(dword[r15 + offsetof(JitState, save_host_MXCSR)]);
+    L(mxcsr_unchanged);
 
     return_from_run_code_without_mxcsr_switch = getCurr<const void*>();
 
-    ABI_PopCalleeSaveRegistersAndAdjustStack(this);
+    ABI_PopCalleeSaveRegistersAndAdjustStack(this, SpillFrameSize);
     ret();
 }
 
 void BlockOfCode::GenMemoryAccessors() {
-    align();
-    read_memory_8 = getCurr<const void*>();
-    ABI_PushCallerSaveRegistersAndAdjustStack(this);
-    CallFunction(cb.MemoryRead8);
-    ABI_PopCallerSaveRegistersAndAdjustStack(this);
-    ret();
-
-    align();
-    read_memory_16 = getCurr<const void*>();
-    ABI_PushCallerSaveRegistersAndAdjustStack(this);
-    CallFunction(cb.MemoryRead16);
-    ABI_PopCallerSaveRegistersAndAdjustStack(this);
-    ret();
-
-    align();
-    read_memory_32 = getCurr<const void*>();
-    ABI_PushCallerSaveRegistersAndAdjustStack(this);
-    CallFunction(cb.MemoryRead32);
-    ABI_PopCallerSaveRegistersAndAdjustStack(this);
-    ret();
-
-    align();
-    read_memory_64 = getCurr<const void*>();
-    ABI_PushCallerSaveRegistersAndAdjustStack(this);
-    CallFunction(cb.MemoryRead64);
-    ABI_PopCallerSaveRegistersAndAdjustStack(this);
-    ret();
-
-    align();
-    write_memory_8 = getCurr<const void*>();
-    ABI_PushCallerSaveRegistersAndAdjustStack(this);
-    CallFunction(cb.MemoryWrite8);
-    ABI_PopCallerSaveRegistersAndAdjustStack(this);
-    ret();
-
-    align();
-    write_memory_16 = getCurr<const void*>();
-    ABI_PushCallerSaveRegistersAndAdjustStack(this);
-    CallFunction(cb.MemoryWrite16);
-    ABI_PopCallerSaveRegistersAndAdjustStack(this);
-    ret();
-
-    align();
-    write_memory_32 = getCurr<const void*>();
-    ABI_PushCallerSaveRegistersAndAdjustStack(this);
-    CallFunction(cb.MemoryWrite32);
-    ABI_PopCallerSaveRegistersAndAdjustStack(this);
-    ret();
-
-    align();
-    write_memory_64 = getCurr<const void*>();
-    ABI_PushCallerSaveRegistersAndAdjustStack(this);
-    CallFunction(cb.MemoryWrite64);
-    ABI_PopCallerSaveRegistersAndAdjustStack(this);
-    ret();
+    size_t index = 0;
+    const auto gen_accessor = [this, &index](auto fn) {
+        align();
+        const void* begin = getCurr<const void*>();
+        ABI_PushCallerSaveRegistersAndAdjustStack(this);
+        CallFunction(fn);
+        ABI_PopCallerSaveRegistersAndAdjustStack(this);
+        ret();
+        memory_accessor_ranges[index++] = {begin, getCurr<const void*>()};
+        return begin;
+    };
+
+    read_memory_8 = gen_accessor(cb.MemoryRead8);
+    read_memory_16 = gen_accessor(cb.MemoryRead16);
+    read_memory_32 = gen_accessor(cb.MemoryRead32);
+    read_memory_64 = gen_accessor(cb.MemoryRead64);
+    write_memory_8 = gen_accessor(cb.MemoryWrite8);
+    write_memory_16 = gen_accessor(cb.MemoryWrite16);
+    write_memory_32 = gen_accessor(cb.MemoryWrite32);
+    write_memory_64 = gen_accessor(cb.MemoryWrite64);
 }
 
 void BlockOfCode::SwitchMxcsrOnEntry() {
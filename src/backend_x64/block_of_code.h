@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 #include <xbyak.h>
 
@@ -134,6 +136,11 @@ public:
     /// The lifetime of this memory is the same as the code around it.
     void* AllocateFromCodeSpace(size_t size);
 
+    /// Number of bytes of the code space in use, including the stubs emitted on construction.
+    size_t SpaceUsed() const { return getSize(); }
+    /// Size in bytes of the code space.
+    size_t SpaceTotal() const { return maxSize_; }
+
     void SetCodePtr(CodePtr code_ptr);
     void EnsurePatchLocationSize(CodePtr begin, size_t size);
 
@@ -188,6 +195,8 @@ private:
     const void* write_memory_16 = nullptr;
     const void* write_memory_32 = nullptr;
     const void* write_memory_64 = nullptr;
+    /// The extent of each memory accessor above, from its first instruction to just past its ret.
+    std::array<std::pair<const void*, const void*>, 8> memory_accessor_ranges{};
     void GenMemoryAccessors();
 
     class UnwindHandler final {
@@ -4,12 +4,17 @@
  * General Public License version 2 or any later version.
  */
 
+#include <iterator>
 #include <unordered_map>
 
+#include <fmt/format.h>
+#include <xbyak_util.h>
+
 #include "backend_x64/abi.h"
 #include "backend_x64/block_of_code.h"
 #include "backend_x64/emit_x64.h"
 #include "backend_x64/jitstate.h"
+#include "backend_x64/perf_map.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
 #include "frontend/arm/types.h"
@@ -51,25 +56,86 @@ static void EraseInstruction(IR::Block& block, IR::Inst* inst) {
     block.Instructions().erase(inst);
 }
 
+static bool HasPageTable(const UserCallbacks& cb) {
+    return cb.page_table || cb.page_directory;
+}
+
+/// Determines whether the code emitted for `inst` performs a RegAlloc::HostCall.
+static bool CallsHost(const UserCallbacks& cb, const IR::Inst& inst) {
+    switch (inst.GetOpcode()) {
+    case IR::Opcode::SetCpsrWithModeSwitch:
+    case IR::Opcode::CallSupervisor:
+    case IR::Opcode::InterpretInstruction:
+        return true;
+    case IR::Opcode::ReadMemory8:
+    case IR::Opcode::ReadMemory16:
+    case IR::Opcode::ReadMemory32:
+    case IR::Opcode::ReadMemory64:
+    case IR::Opcode::WriteMemory8:
+    case IR::Opcode::WriteMemory16:
+    case IR::Opcode::WriteMemory32:
+    case IR::Opcode::WriteMemory64:
+    case IR::Opcode::ExclusiveWriteMemory8:
+    case IR::Opcode::ExclusiveWriteMemory16:
+    case IR::Opcode::ExclusiveWriteMemory32:
+    case IR::Opcode::ExclusiveWriteMemory64:
+        return !HasPageTable(cb);
+    default:
+        return false;
+    }
+}
+
+static u32 DetectHostFeatures() {
+    using Xbyak::util::Cpu;
+    Cpu cpu_info;
+
+    u32 features = 0;
+    if (cpu_info.has(Cpu::tSSSE3))
+        features |= HostFeature::SSSE3;
+    if (cpu_info.has(Cpu::tAVX))
+        features |= HostFeature::AVX;
+    if (cpu_info.has(Cpu::tBMI2))
+        features |= HostFeature::BMI2;
+    if (cpu_info.has(Cpu::tLZCNT))
+        features |= HostFeature::LZCNT;
+    if (cpu_info.has(Cpu::tMOVBE))
+        features |= HostFeature::MOVBE;
+    if (cpu_info.has(Cpu::tSSE41))
+        features |= HostFeature::SSE41;
+    return features;
+}
+
+// R14 is reserved for the page table base pointer if there is one (See: BlockOfCode::GenRunCode).
 EmitX64::EmitX64(BlockOfCode* code, UserCallbacks cb, Jit* jit_interface)
-    : reg_alloc(code), code(code), cb(cb), jit_interface(jit_interface) {
+    : host_features(DetectHostFeatures() & ~cb.disabled_host_features), reg_alloc(code, HasPageTable(cb) ? HostLocList{HostLoc::R14} : HostLocList{}), code(code), cb(cb), jit_interface(jit_interface) {
+    ASSERT_MSG(cb.rsb_size != 0 && (cb.rsb_size & (cb.rsb_size - 1)) == 0, "rsb_size must be a power of 2");
+    ASSERT_MSG(cb.rsb_size <= JitState::RSBMaxSize, "rsb_size must be no greater than %zu", JitState::RSBMaxSize);
+    ASSERT_MSG(!cb.page_table || !cb.page_directory, "At most one of page_table and page_directory may be provided");
+    ASSERT_MSG(!cb.page_table || cb.page_bits == UserCallbacks::PAGE_BITS, "page_table only supports 4K pages");
+    ASSERT_MSG(cb.page_bits >= UserCallbacks::PAGE_BITS && cb.page_bits <= UserCallbacks::PAGE_DIRECTORY_SHIFT, "Invalid page_bits");
 }
 
 EmitX64::BlockDescriptor EmitX64::Emit(IR::Block& block) {
     const IR::LocationDescriptor descriptor = block.Location();
 
-    reg_alloc.Reset();
+    reg_alloc.Reset(block, [this](const IR::Inst& inst){ return CallsHost(cb, inst); });
 
     code->align();
     const CodePtr code_ptr = code->getCurr();
     basic_blocks[descriptor].code_ptr = code_ptr;
     unique_hash_to_code_ptr[descriptor.UniqueHash()] = code_ptr;
 
+    if (cb.enable_block_profiling) {
+        EmitBlockProfileCounter(block);
+    }
+
     EmitCondPrelude(block);
 
     for (auto iter = block.begin(); iter != block.end(); ++iter) {
         IR::Inst* inst = &*iter;
 
+        reg_alloc.StartOfAllocScope(inst);
+
         // Call the relevant Emit* member function.
         switch (inst->GetOpcode()) {
 
@@ -96,6 +162,14 @@ EmitX64::BlockDescriptor EmitX64::Emit(IR::Block& block) {
 
     Patch(descriptor, code_ptr);
     basic_blocks[descriptor].size = std::intptr_t(code->getCurr()) - std::intptr_t(code_ptr);
+
+    if (cb.enable_perf_map) {
+        const std::string name = fmt::format("dynarmic_{}_{:08x}_fpscr_{:08x}{}",
+                                             descriptor.TFlag() ? "thumb" : "arm", descriptor.PC(),
+                                             descriptor.FPSCR().Value(), descriptor.EFlag() ? "_be" : "");
+        PerfMapRegister(code_ptr, basic_blocks[descriptor].size, name);
+    }
+
     return basic_blocks[descriptor];
 }
 
@@ -172,6 +246,34 @@ void EmitX64::EmitSetCpsr(IR::Block&, IR::Inst* inst) {
     code->mov(MJitStateCpsr(), arg);
 }
 
+static void SetCpsrWithModeSwitchImpl(u32 value, JitState* jit_state) {
+    jit_state->SetCpsrWithModeSwitch(value);
+}
+
+void EmitX64::EmitSetCpsrWithModeSwitch(IR::Block&, IR::Inst* inst) {
+    auto a = inst->GetArg(0);
+
+    reg_alloc.HostCall(nullptr, a);
+    code->mov(code->ABI_PARAM2, code->r15);
+
+    // SetCpsrWithModeSwitchImpl does not touch floating-point state.
+    code->CallFunction(&SetCpsrWithModeSwitchImpl);
+}
+
+void EmitX64::EmitGetSpsr(IR::Block&, IR::Inst* inst) {
+    using namespace Xbyak::util;
+
+    Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
+    code->mov(result, dword[r15 + offsetof(JitState, Spsr)]);
+}
+
+void EmitX64::EmitSetSpsr(IR::Block&, IR::Inst* inst) {
+    using namespace Xbyak::util;
+
+    Xbyak::Reg32 arg = reg_alloc.UseGpr(inst->GetArg(0)).cvt32();
+    code->mov(dword[r15 + offsetof(JitState, Spsr)], arg);
+}
+
 void EmitX64::EmitGetNFlag(IR::Block&, IR::Inst* inst) {
     Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
     code->mov(result, MJitStateCpsr());
@@ -365,37 +467,133 @@ void EmitX64::EmitCallSupervisor(IR::Block&, IR::Inst* inst) {
 
     reg_alloc.HostCall(nullptr, imm32);
 
+    if (cb.CallSVC_is_mxcsr_agnostic) {
+        code->CallFunction(cb.CallSVC);
+        return;
+    }
+
     code->SwitchMxcsrOnExit();
     code->CallFunction(cb.CallSVC);
     code->SwitchMxcsrOnEntry();
 }
 
-static u32 GetFpscrImpl(JitState* jit_state) {
-    return jit_state->Fpscr();
+void EmitX64::EmitInterpretInstruction(IR::Block& block, IR::Inst* inst) {
+    using namespace Xbyak::util;
+
+    const u32 pc = inst->GetArg(0).GetU32();
+    const u32 next_pc = inst->GetArg(1).GetU32();
+    const u32 cycles_so_far = inst->GetArg(2).GetU32();
+
+    reg_alloc.HostCall(nullptr);
+
+    code->mov(code->ABI_PARAM1.cvt32(), pc);
+    code->mov(code->ABI_PARAM2, reinterpret_cast<u64>(jit_interface));
+    code->mov(code->ABI_PARAM3, reinterpret_cast<u64>(cb.user_arg));
+    code->mov(MJitStateReg(Arm::Reg::PC), code->ABI_PARAM1.cvt32());
+    if (cb.InterpreterFallback_is_mxcsr_agnostic) {
+        code->CallFunction(cb.InterpreterFallback);
+    } else {
+        code->SwitchMxcsrOnExit();
+        code->CallFunction(cb.InterpreterFallback);
+        code->SwitchMxcsrOnEntry();
+    }
+
+    // The remainder of this block assumes that the interpreter continued at the next instruction
+    // without changing any of the state that the block was translated under.
+    // If this is not the case, we return to the dispatcher.
+    const IR::LocationDescriptor location = block.Location();
+    const u32 expected_cpsr_mode = location.CPSR().Value();
+    const u32 expected_fpscr_mode = location.FPSCR().Value();
+
+    Xbyak::Label exit_block, continue_block;
+
+    code->cmp(MJitStateReg(Arm::Reg::PC), next_pc);
+    code->jne(exit_block, code->T_NEAR);
+    code->mov(eax, MJitStateCpsr());
+    code->and_(eax, IR::LocationDescriptor::CPSR_MODE_MASK);
+    code->cmp(eax, expected_cpsr_mode);
+    code->jne(exit_block, code->T_NEAR);
+    code->cmp(dword[r15 + offsetof(JitState, FPSCR_mode)], expected_fpscr_mode);
+    code->je(continue_block, code->T_NEAR);
+    code->L(exit_block);
+    EmitAddCycles(cycles_so_far);
+    code->ReturnFromRunCode();
+    code->L(continue_block);
 }
 
 void EmitX64::EmitGetFpscr(IR::Block&, IR::Inst* inst) {
-    reg_alloc.HostCall(inst);
-    code->mov(code->ABI_PARAM1, code->r15);
+    using namespace Xbyak::util;
 
-    code->SwitchMxcsrOnExit();
-    code->CallFunction(&GetFpscrImpl);
-    code->SwitchMxcsrOnEntry();
-}
+    // This calculation has to match up with JitState::Fpscr
+    Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
+    Xbyak::Reg32 tmp = reg_alloc.ScratchGpr().cvt32();
 
-static void SetFpscrImpl(u32 value, JitState* jit_state) {
-    jit_state->SetFpscr(value);
+    code->stmxcsr(dword[r15 + offsetof(JitState, guest_MXCSR)]);
+    code->mov(result, dword[r15 + offsetof(JitState, guest_MXCSR)]);
+    code->mov(tmp, result);
+    code->and_(result, 0b0000000000001); // IOC = IE
+    code->and_(tmp, 0b0000000111100);
+    code->shr(tmp, 1);                   // IXC, UFC, OFC, DZC = PE, UE, OE, ZE
+    code->or_(result, tmp);
+    code->or_(result, dword[r15 + offsetof(JitState, FPSCR_mode)]);
+    code->or_(result, dword[r15 + offsetof(JitState, FPSCR_nzcv)]);
+    code->or_(result, dword[r15 + offsetof(JitState, FPSCR_IDC)]);
+    code->or_(result, dword[r15 + offsetof(JitState, FPSCR_UFC)]);
 }
 
 void EmitX64::EmitSetFpscr(IR::Block&, IR::Inst* inst) {
-    auto a = inst->GetArg(0);
-
-    reg_alloc.HostCall(nullptr, a);
-    code->mov(code->ABI_PARAM2, code->r15);
+    using namespace Xbyak::util;
 
-    code->SwitchMxcsrOnExit();
-    code->CallFunction(&SetFpscrImpl);
-    code->SwitchMxcsrOnEntry();
+    // This calculation has to match up with JitState::SetFpscr
+    Xbyak::Reg32 value = reg_alloc.UseGpr(inst->GetArg(0)).cvt32();
+    Xbyak::Reg32 mxcsr = reg_alloc.ScratchGpr().cvt32();
+    Xbyak::Reg32 tmp = reg_alloc.ScratchGpr().cvt32();
+
+    code->mov(dword[r15 + offsetof(JitState, old_FPSCR)], value);
+
+    const auto store_field = [&](size_t offset, u32 mask) {
+        code->mov(tmp, value);
+        code->and_(tmp, mask);
+        code->mov(dword[r15 + offset], tmp);
+    };
+    store_field(offsetof(JitState, FPSCR_mode), IR::LocationDescriptor::FPSCR_MODE_MASK);
+    store_field(offsetof(JitState, FPSCR_nzcv), 0xF0000000);
+    store_field(offsetof(JitState, FPSCR_IDC), 1 << 7);
+    store_field(offsetof(JitState, FPSCR_UFC), 1 << 3);
+
+    // Exception masks: mask all
+    code->mov(mxcsr, 0x00001f80);
+
+    // RMode: FPSCR bits 22-23 are MXCSR bits 14-13 respectively
+    code->mov(tmp, value);
+    code->shr(tmp, 22 - 14);
+    code->and_(tmp, 1 << 14);
+    code->or_(mxcsr, tmp);
+    code->mov(tmp, value);
+    code->shr(tmp, 23 - 13);
+    code->and_(tmp, 1 << 13);
+    code->or_(mxcsr, tmp);
+
+    // Cumulative flags IOC, IXC, UFC, OFC, DZC
+    code->mov(tmp, value);
+    code->and_(tmp, 0b0000000000001);    // IE = IOC
+    code->or_(mxcsr, tmp);
+    code->lea(tmp, ptr[value.cvt64() + value.cvt64()]);
+    code->and_(tmp, 0b0000000111100);    // PE, UE, OE, ZE = IXC, UFC, OFC, DZC
+    code->or_(mxcsr, tmp);
+
+    // VFP Flush to Zero: SSE Denormals are Zero, and SSE Flush to Zero if we're not emulating it
+    code->mov(tmp, value);
+    code->shr(tmp, 24 - 6);
+    code->and_(tmp, 1 << 6);
+    code->or_(mxcsr, tmp);
+    if (cb.fast_fp) {
+        code->shl(tmp, 15 - 6);
+        code->or_(mxcsr, tmp);
+    }
+
+    code->mov(dword[r15 + offsetof(JitState, guest_MXCSR)], mxcsr);
+    code->ldmxcsr(dword[r15 + offsetof(JitState, guest_MXCSR)]);
 }
 
 void EmitX64::EmitGetFpscrNZCV(IR::Block&, IR::Inst* inst) {
@@ -429,7 +627,7 @@ void EmitX64::EmitPushRSB(IR::Block&, IR::Inst* inst) {
 
     code->mov(index_reg, dword[r15 + offsetof(JitState, rsb_ptr)]);
     code->add(index_reg, 1);
-    code->and_(index_reg, u32(JitState::RSBSize - 1));
+    code->and_(index_reg, u32(cb.rsb_size - 1));
 
     code->mov(loc_desc_reg, imm64);
     CodePtr patch_location = code->getCurr<CodePtr>();
@@ -437,16 +635,9 @@ void EmitX64::EmitPushRSB(IR::Block&, IR::Inst* inst) {
     code->mov(code_ptr_reg, code_ptr); // This line has to match up with EmitX64::Patch.
     code->EnsurePatchLocationSize(patch_location, 10);
 
-    Xbyak::Label label;
-    for (size_t i = 0; i < JitState::RSBSize; ++i) {
-        code->cmp(loc_desc_reg, qword[r15 + offsetof(JitState, rsb_location_descriptors) + i * sizeof(u64)]);
-        code->je(label, code->T_SHORT);
-    }
-
     code->mov(dword[r15 + offsetof(JitState, rsb_ptr)], index_reg);
     code->mov(qword[r15 + index_reg.cvt64() * 8 + offsetof(JitState, rsb_location_descriptors)], loc_desc_reg);
     code->mov(qword[r15 + index_reg.cvt64() * 8 + offsetof(JitState, rsb_codeptrs)], code_ptr_reg);
-    code->L(label);
 }
 
 void EmitX64::EmitGetCarryFromOp(IR::Block&, IR::Inst*) {
@@ -537,8 +728,6 @@ void EmitX64::EmitIsZero64(IR::Block&, IR::Inst* inst) {
 void EmitX64::EmitLogicalShiftLeft(IR::Block& block, IR::Inst* inst) {
     auto carry_inst = inst->GetAssociatedPseudoOperation(IR::Opcode::GetCarryFromOp);
 
-    // TODO: Consider using BMI2 instructions like SHLX when arm-in-host flags is implemented.
-
     if (!carry_inst) {
         if (!inst->GetArg(2).IsImmediate()) {
             // TODO: Remove redundant argument.
@@ -556,6 +745,18 @@ void EmitX64::EmitLogicalShiftLeft(IR::Block& block, IR::Inst* inst) {
             } else {
                 code->xor_(result, result);
             }
+        } else if (HasHostFeature(HostFeature::BMI2)) {
+            Xbyak::Reg32 shift = reg_alloc.UseGpr(shift_arg).cvt32();
+            Xbyak::Reg32 source = reg_alloc.UseGpr(inst->GetArg(0)).cvt32();
+            Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
+            Xbyak::Reg32 zero = reg_alloc.ScratchGpr().cvt32();
+
+            // SHLX does not affect flags and does not require the count to be in CL.
+            // Note that result may share a register with shift.
+            code->xor_(zero, zero);
+            code->cmp(shift.cvt8(), 32);
+            code->shlx(result, source, shift);
+            code->cmovnb(result, zero);
         } else {
             Xbyak::Reg8 shift = reg_alloc.UseGpr(shift_arg, {HostLoc::RCX}).cvt8();
             Xbyak::Reg32 result = reg_alloc.UseDefGpr(inst->GetArg(0), inst).cvt32();
@@ -649,6 +850,18 @@ void EmitX64::EmitLogicalShiftRight(IR::Block& block, IR::Inst* inst) {
             } else {
                 code->xor_(result, result);
             }
+        } else if (HasHostFeature(HostFeature::BMI2)) {
+            Xbyak::Reg32 shift = reg_alloc.UseGpr(shift_arg).cvt32();
+            Xbyak::Reg32 source = reg_alloc.UseGpr(inst->GetArg(0)).cvt32();
+            Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
+            Xbyak::Reg32 zero = reg_alloc.ScratchGpr().cvt32();
+
+            // SHRX does not affect flags and does not require the count to be in CL.
+            // Note that result may share a register with shift.
+            code->xor_(zero, zero);
+            code->cmp(shift.cvt8(), 32);
+            code->shrx(result, source, shift);
+            code->cmovnb(result, zero);
         } else {
             Xbyak::Reg8 shift = reg_alloc.UseGpr(shift_arg, {HostLoc::RCX}).cvt8();
             Xbyak::Reg32 result = reg_alloc.UseDefGpr(inst->GetArg(0), inst).cvt32();
@@ -750,6 +963,18 @@ void EmitX64::EmitArithmeticShiftRight(IR::Block& block, IR::Inst* inst) {
             Xbyak::Reg32 result = reg_alloc.UseDefGpr(inst->GetArg(0), inst).cvt32();
 
             code->sar(result, u8(shift < 31 ? shift : 31));
+        } else if (HasHostFeature(HostFeature::BMI2)) {
+            Xbyak::Reg32 shift = reg_alloc.UseScratchGpr(shift_arg).cvt32();
+            Xbyak::Reg32 source = reg_alloc.UseGpr(inst->GetArg(0)).cvt32();
+            Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
+            Xbyak::Reg32 const31 = reg_alloc.ScratchGpr().cvt32();
+
+            // All shift values above 31 have the same behaviour as 31 does (See below).
+            code->mov(const31, 31);
+            code->movzx(shift, shift.cvt8());
+            code->cmp(shift, u32(31));
+            code->cmovg(shift, const31);
+            code->sarx(result, source, shift);
         } else {
             Xbyak::Reg32 shift = reg_alloc.UseScratchGpr(shift_arg, {HostLoc::RCX}).cvt32();
             Xbyak::Reg32 result = reg_alloc.UseDefGpr(inst->GetArg(0), inst).cvt32();
@@ -828,7 +1053,13 @@ void EmitX64::EmitRotateRight(IR::Block& block, IR::Inst* inst) {
 
         auto shift_arg = inst->GetArg(1);
 
-        if (shift_arg.IsImmediate()) {
+        if (shift_arg.IsImmediate() && HasHostFeature(HostFeature::BMI2)) {
+            u8 shift = shift_arg.GetU8();
+            Xbyak::Reg32 source = reg_alloc.UseGpr(inst->GetArg(0)).cvt32();
+            Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
+
+            code->rorx(result, source, u8(shift & 0x1F));
+        } else if (shift_arg.IsImmediate()) {
             u8 shift = shift_arg.GetU8();
             Xbyak::Reg32 result = reg_alloc.UseDefGpr(inst->GetArg(0), inst).cvt32();
 
@@ -1238,7 +1469,10 @@ void EmitX64::EmitZeroExtendByteToWord(IR::Block&, IR::Inst* inst) {
     code->movzx(result.cvt32(), *source);
 }
 
-void EmitX64::EmitByteReverseWord(IR::Block&, IR::Inst* inst) {
+void EmitX64::EmitByteReverseWord(IR::Block& block, IR::Inst* inst) {
+    if (FoldByteReverseIntoWrite(block, inst, 32))
+        return;
+
     Xbyak::Reg32 result = reg_alloc.UseDefGpr(inst->GetArg(0), inst).cvt32();
 
     code->bswap(result);
@@ -1250,7 +1484,10 @@ void EmitX64::EmitByteReverseHalf(IR::Block&, IR::Inst* inst) {
     code->rol(result, 8);
 }
 
-void EmitX64::EmitByteReverseDual(IR::Block&, IR::Inst* inst) {
+void EmitX64::EmitByteReverseDual(IR::Block& block, IR::Inst* inst) {
+    if (FoldByteReverseIntoWrite(block, inst, 64))
+        return;
+
     Xbyak::Reg64 result = reg_alloc.UseDefGpr(inst->GetArg(0), inst);
 
     code->bswap(result);
@@ -1259,7 +1496,7 @@ void EmitX64::EmitByteReverseDual(IR::Block&, IR::Inst* inst) {
 void EmitX64::EmitCountLeadingZeros(IR::Block&, IR::Inst* inst) {
     IR::Value a = inst->GetArg(0);
 
-    if (cpu_info.has(Xbyak::util::Cpu::tLZCNT)) {
+    if (HasHostFeature(HostFeature::LZCNT)) {
         Xbyak::Reg32 source = reg_alloc.UseGpr(a).cvt32();
         Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
 
@@ -1363,7 +1600,7 @@ void EmitX64::EmitPackedAddU8(IR::Block& block, IR::Inst* inst) {
     }
     code->xor_(result, reg_a);
     if (ge_inst) {
-        if (cpu_info.has(Xbyak::util::Cpu::tBMI2)) {
+        if (HasHostFeature(HostFeature::BMI2)) {
             code->mov(tmp, 0x80808080);
             code->pext(reg_ge, reg_ge, tmp);
         } else {
@@ -1408,7 +1645,7 @@ void EmitX64::EmitPackedSubU8(IR::Block& block, IR::Inst* inst) {
     code->movd(reg_a, xmm_a);
 
     if (ge_inst) {
-        if (cpu_info.has(Xbyak::util::Cpu::tBMI2)) {
+        if (HasHostFeature(HostFeature::BMI2)) {
             Xbyak::Reg32 tmp = reg_alloc.ScratchGpr().cvt32();
             code->mov(tmp, 0x80808080);
             code->pext(reg_ge, reg_ge, tmp);
@@ -1426,7 +1663,7 @@ void EmitX64::EmitPackedHalvingAddU8(IR::Block&, IR::Inst* inst) {
 
     // This code path requires SSSE3 because of the PSHUFB instruction.
     // A fallback implementation is provided below.
-    if (cpu_info.has(Xbyak::util::Cpu::tSSSE3)) {
+    if (HasHostFeature(HostFeature::SSSE3)) {
         Xbyak::Reg32 result = reg_alloc.UseDefGpr(a, inst).cvt32();
         Xbyak::Reg32 arg = reg_alloc.UseGpr(b).cvt32();
 
@@ -1671,6 +1908,16 @@ void EmitX64::EmitPackedSaturatedSubS16(IR::Block&, IR::Inst* inst) {
     EmitPackedOperation(code, reg_alloc, inst, &Xbyak::CodeGenerator::psubsw);
 }
 
+/// Whether FPSCR.FZ has to be emulated in software. If not, the MXCSR's DAZ and FTZ bits are used (See: UserCallbacks::fast_fp).
+static bool SoftwareFTZ(const UserCallbacks& cb, const IR::Block& block) {
+    return !cb.fast_fp && block.Location().FPSCR().FTZ();
+}
+
+/// Whether FPSCR.DN has to be emulated in software. If not, NaNs propagate as they would on the host.
+static bool SoftwareDN(const UserCallbacks& cb, const IR::Block& block) {
+    return !cb.fast_fp && block.Location().FPSCR().DN();
+}
+
 static void DenormalsAreZero32(BlockOfCode* code, Xbyak::Xmm xmm_value, Xbyak::Reg32 gpr_scratch) {
     using namespace Xbyak::util;
     Xbyak::Label end;
@@ -1764,82 +2011,111 @@ static void ZeroIfNaN64(BlockOfCode* code, Xbyak::Xmm xmm_value, Xbyak::Xmm xmm_
     code->pand(xmm_value, xmm_scratch);
 }
 
-static void FPThreeOp32(BlockOfCode* code, RegAlloc& reg_alloc, IR::Block& block, IR::Inst* inst, void (Xbyak::CodeGenerator::*fn)(const Xbyak::Xmm&, const Xbyak::Operand&)) {
+using FPSseFn = void (Xbyak::CodeGenerator::*)(const Xbyak::Xmm&, const Xbyak::Operand&);
+using FPAvxFn = void (Xbyak::CodeGenerator::*)(const Xbyak::Xmm&, const Xbyak::Operand&, const Xbyak::Operand&);
+
+static void FPThreeOp32(BlockOfCode* code, RegAlloc& reg_alloc, const UserCallbacks& cb, bool use_avx, IR::Block& block, IR::Inst* inst, FPSseFn fn, FPAvxFn vex_fn) {
     IR::Value a = inst->GetArg(0);
     IR::Value b = inst->GetArg(1);
 
+    if (use_avx && !SoftwareFTZ(cb, block)) {
+        // The VEX encoding is non-destructive, so we avoid a copy when `a` has further uses.
+        Xbyak::Xmm operand1 = reg_alloc.UseXmm(a);
+        Xbyak::Xmm operand2 = reg_alloc.UseXmm(b);
+        Xbyak::Xmm result = reg_alloc.DefXmm(inst);
+
+        (code->*vex_fn)(result, operand1, operand2);
+        if (SoftwareDN(cb, block)) {
+            DefaultNaN32(code, result);
+        }
+        return;
+    }
+
     Xbyak::Xmm result = reg_alloc.UseDefXmm(a, inst);
     Xbyak::Xmm operand = reg_alloc.UseXmm(b);
     Xbyak::Reg32 gpr_scratch = reg_alloc.ScratchGpr().cvt32();
 
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         DenormalsAreZero32(code, result, gpr_scratch);
         DenormalsAreZero32(code, operand, gpr_scratch);
     }
     (code->*fn)(result, operand);
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         FlushToZero32(code, result, gpr_scratch);
     }
-    if (block.Location().FPSCR().DN()) {
+    if (SoftwareDN(cb, block)) {
         DefaultNaN32(code, result);
     }
 }
 
-static void FPThreeOp64(BlockOfCode* code, RegAlloc& reg_alloc, IR::Block& block, IR::Inst* inst, void (Xbyak::CodeGenerator::*fn)(const Xbyak::Xmm&, const Xbyak::Operand&)) {
+static void FPThreeOp64(BlockOfCode* code, RegAlloc& reg_alloc, const UserCallbacks& cb, bool use_avx, IR::Block& block, IR::Inst* inst, FPSseFn fn, FPAvxFn vex_fn) {
     IR::Value a = inst->GetArg(0);
     IR::Value b = inst->GetArg(1);
 
+    if (use_avx && !SoftwareFTZ(cb, block)) {
+        // The VEX encoding is non-destructive, so we avoid a copy when `a` has further uses.
+        Xbyak::Xmm operand1 = reg_alloc.UseXmm(a);
+        Xbyak::Xmm operand2 = reg_alloc.UseXmm(b);
+        Xbyak::Xmm result = reg_alloc.DefXmm(inst);
+
+        (code->*vex_fn)(result, operand1, operand2);
+        if (SoftwareDN(cb, block)) {
+            DefaultNaN64(code, result);
+        }
+        return;
+    }
+
     Xbyak::Xmm result = reg_alloc.UseDefXmm(a, inst);
     Xbyak::Xmm operand = reg_alloc.UseXmm(b);
     Xbyak::Reg64 gpr_scratch = reg_alloc.ScratchGpr();
 
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         DenormalsAreZero64(code, result, gpr_scratch);
         DenormalsAreZero64(code, operand, gpr_scratch);
     }
     (code->*fn)(result, operand);
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         FlushToZero64(code, result, gpr_scratch);
     }
-    if (block.Location().FPSCR().DN()) {
+    if (SoftwareDN(cb, block)) {
         DefaultNaN64(code, result);
     }
 }
 
-static void FPTwoOp32(BlockOfCode* code, RegAlloc& reg_alloc, IR::Block& block, IR::Inst* inst, void (Xbyak::CodeGenerator::*fn)(const Xbyak::Xmm&, const Xbyak::Operand&)) {
+static void FPTwoOp32(BlockOfCode* code, RegAlloc& reg_alloc, const UserCallbacks& cb, IR::Block& block, IR::Inst* inst, void (Xbyak::CodeGenerator::*fn)(const Xbyak::Xmm&, const Xbyak::Operand&)) {
     IR::Value a = inst->GetArg(0);
 
     Xbyak::Xmm result = reg_alloc.UseDefXmm(a, inst);
     Xbyak::Reg32 gpr_scratch = reg_alloc.ScratchGpr().cvt32();
 
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         DenormalsAreZero32(code, result, gpr_scratch);
     }
 
     (code->*fn)(result, result);
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         FlushToZero32(code, result, gpr_scratch);
     }
-    if (block.Location().FPSCR().DN()) {
+    if (SoftwareDN(cb, block)) {
         DefaultNaN32(code, result);
     }
 }
 
-static void FPTwoOp64(BlockOfCode* code, RegAlloc& reg_alloc, IR::Block& block, IR::Inst* inst, void (Xbyak::CodeGenerator::*fn)(const Xbyak::Xmm&, const Xbyak::Operand&)) {
+static void FPTwoOp64(BlockOfCode* code, RegAlloc& reg_alloc, const UserCallbacks& cb, IR::Block& block, IR::Inst* inst, void (Xbyak::CodeGenerator::*fn)(const Xbyak::Xmm&, const Xbyak::Operand&)) {
     IR::Value a = inst->GetArg(0);
 
     Xbyak::Xmm result = reg_alloc.UseDefXmm(a, inst);
     Xbyak::Reg64 gpr_scratch = reg_alloc.ScratchGpr();
 
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         DenormalsAreZero64(code, result, gpr_scratch);
     }
 
     (code->*fn)(result, result);
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         FlushToZero64(code, result, gpr_scratch);
     }
-    if (block.Location().FPSCR().DN()) {
+    if (SoftwareDN(cb, block)) {
         DefaultNaN64(code, result);
     }
 }
@@ -1915,43 +2191,43 @@ void EmitX64::EmitFPNeg64(IR::Block&, IR::Inst* inst) {
 }
 
 void EmitX64::EmitFPAdd32(IR::Block& block, IR::Inst* inst) {
-    FPThreeOp32(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::addss);
+    FPThreeOp32(code, reg_alloc, cb, HasHostFeature(HostFeature::AVX), block, inst, &Xbyak::CodeGenerator::addss, &Xbyak::CodeGenerator::vaddss);
 }
 
 void EmitX64::EmitFPAdd64(IR::Block& block, IR::Inst* inst) {
-    FPThreeOp64(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::addsd);
+    FPThreeOp64(code, reg_alloc, cb, HasHostFeature(HostFeature::AVX), block, inst, &Xbyak::CodeGenerator::addsd, &Xbyak::CodeGenerator::vaddsd);
 }
 
 void EmitX64::EmitFPDiv32(IR::Block& block, IR::Inst* inst) {
-    FPThreeOp32(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::divss);
+    FPThreeOp32(code, reg_alloc, cb, HasHostFeature(HostFeature::AVX), block, inst, &Xbyak::CodeGenerator::divss, &Xbyak::CodeGenerator::vdivss);
 }
 
 void EmitX64::EmitFPDiv64(IR::Block& block, IR::Inst* inst) {
-    FPThreeOp64(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::divsd);
+    FPThreeOp64(code, reg_alloc, cb, HasHostFeature(HostFeature::AVX), block, inst, &Xbyak::CodeGenerator::divsd, &Xbyak::CodeGenerator::vdivsd);
 }
 
 void EmitX64::EmitFPMul32(IR::Block& block, IR::Inst* inst) {
-    FPThreeOp32(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::mulss);
+    FPThreeOp32(code, reg_alloc, cb, HasHostFeature(HostFeature::AVX), block, inst, &Xbyak::CodeGenerator::mulss, &Xbyak::CodeGenerator::vmulss);
 }
 
 void EmitX64::EmitFPMul64(IR::Block& block, IR::Inst* inst) {
-    FPThreeOp64(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::mulsd);
+    FPThreeOp64(code, reg_alloc, cb, HasHostFeature(HostFeature::AVX), block, inst, &Xbyak::CodeGenerator::mulsd, &Xbyak::CodeGenerator::vmulsd);
 }
 
 void EmitX64::EmitFPSqrt32(IR::Block& block, IR::Inst* inst) {
-    FPTwoOp32(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::sqrtss);
+    FPTwoOp32(code, reg_alloc, cb, block, inst, &Xbyak::CodeGenerator::sqrtss);
 }
 
 void EmitX64::EmitFPSqrt64(IR::Block& block, IR::Inst* inst) {
-    FPTwoOp64(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::sqrtsd);
+    FPTwoOp64(code, reg_alloc, cb, block, inst, &Xbyak::CodeGenerator::sqrtsd);
 }
 
 void EmitX64::EmitFPSub32(IR::Block& block, IR::Inst* inst) {
-    FPThreeOp32(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::subss);
+    FPThreeOp32(code, reg_alloc, cb, HasHostFeature(HostFeature::AVX), block, inst, &Xbyak::CodeGenerator::subss, &Xbyak::CodeGenerator::vsubss);
 }
 
 void EmitX64::EmitFPSub64(IR::Block& block, IR::Inst* inst) {
-    FPThreeOp64(code, reg_alloc, block, inst, &Xbyak::CodeGenerator::subsd);
+    FPThreeOp64(code, reg_alloc, cb, HasHostFeature(HostFeature::AVX), block, inst, &Xbyak::CodeGenerator::subsd, &Xbyak::CodeGenerator::vsubsd);
 }
 
 static void SetFpscrNzcvFromFlags(BlockOfCode* code, RegAlloc& reg_alloc) {
@@ -2017,14 +2293,14 @@ void EmitX64::EmitFPSingleToDouble(IR::Block& block, IR::Inst* inst) {
     Xbyak::Xmm result = reg_alloc.UseDefXmm(a, inst);
     Xbyak::Reg64 gpr_scratch = reg_alloc.ScratchGpr();
 
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         DenormalsAreZero32(code, result, gpr_scratch.cvt32());
     }
     code->cvtss2sd(result, result);
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         FlushToZero64(code, result, gpr_scratch);
     }
-    if (block.Location().FPSCR().DN()) {
+    if (SoftwareDN(cb, block)) {
         DefaultNaN64(code, result);
     }
 }
@@ -2035,18 +2311,43 @@ void EmitX64::EmitFPDoubleToSingle(IR::Block& block, IR::Inst* inst) {
     Xbyak::Xmm result = reg_alloc.UseDefXmm(a, inst);
     Xbyak::Reg64 gpr_scratch = reg_alloc.ScratchGpr();
 
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         DenormalsAreZero64(code, result, gpr_scratch);
     }
     code->cvtsd2ss(result, result);
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         FlushToZero32(code, result, gpr_scratch.cvt32());
     }
-    if (block.Location().FPSCR().DN()) {
+    if (SoftwareDN(cb, block)) {
         DefaultNaN32(code, result);
     }
 }
 
+/**
+ * Converts the double in `from` to a saturated 32-bit integer in `to` (SSE4.1 only).
+ * Rounding to an integral value first makes the final conversion exact, so saturation reduces
+ * to a branchless clamp and the unsigned case needs no range shifting.
+ */
+static void DoubleToInt32SSE41(BlockOfCode* code, Xbyak::Xmm to, Xbyak::Xmm from, Xbyak::Xmm xmm_scratch, Xbyak::Reg64 gpr_scratch, bool is_signed, bool round_towards_zero) {
+    // imm8 = 0b011: truncate; imm8 = 0b100: round according to MXCSR.RC. Inexact is signalled.
+    code->roundsd(from, from, round_towards_zero ? 0b011 : 0b100);
+    // First conversion is only to set the invalid operation flag
+    if (is_signed) {
+        code->cvttsd2si(gpr_scratch.cvt32(), from);
+    } else {
+        code->movaps(xmm_scratch, from);
+        code->addsd(xmm_scratch, code->MFloatMinS32());
+        code->cvttsd2si(gpr_scratch.cvt32(), xmm_scratch);
+    }
+    // Clamp to output range
+    ZeroIfNaN64(code, from, xmm_scratch);
+    code->maxsd(from, is_signed ? code->MFloatMinS32() : code->MFloatMinU32());
+    code->minsd(from, is_signed ? code->MFloatMaxS32() : code->MFloatMaxU32());
+    // Exact, and every u32 fits in a 64-bit signed conversion
+    code->cvttsd2si(gpr_scratch, from); // 64 bit gpr
+    code->movd(to, gpr_scratch.cvt32());
+}
+
 void EmitX64::EmitFPSingleToS32(IR::Block& block, IR::Inst* inst) {
     IR::Value a = inst->GetArg(0);
     bool round_towards_zero = inst->GetArg(1).GetU1();
@@ -2059,10 +2360,14 @@ void EmitX64::EmitFPSingleToS32(IR::Block& block, IR::Inst* inst) {
     // ARM saturates on conversion; this differs from x64 which returns a sentinel value.
     // Conversion to double is lossless, and allows for clamping.
 
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         DenormalsAreZero32(code, from, gpr_scratch);
     }
     code->cvtss2sd(from, from);
+    if (HasHostFeature(HostFeature::SSE41)) {
+        DoubleToInt32SSE41(code, to, from, xmm_scratch, gpr_scratch.cvt64(), true, round_towards_zero);
+        return;
+    }
     // First time is to set flags
     if (round_towards_zero) {
         code->cvttsd2si(gpr_scratch, from); // 32 bit gpr
@@ -2098,8 +2403,14 @@ void EmitX64::EmitFPSingleToU32(IR::Block& block, IR::Inst* inst) {
     //
     // FIXME: Inexact exception not correctly signalled with the below code
 
-    if (block.Location().FPSCR().RMode() != Arm::FPSCR::RoundingMode::TowardsZero && !round_towards_zero) {
-        if (block.Location().FPSCR().FTZ()) {
+    if (HasHostFeature(HostFeature::SSE41)) {
+        if (SoftwareFTZ(cb, block)) {
+            DenormalsAreZero32(code, from, gpr_scratch);
+        }
+        code->cvtss2sd(from, from);
+        DoubleToInt32SSE41(code, to, from, xmm_scratch, gpr_scratch.cvt64(), false, round_towards_zero);
+    } else if (block.Location().FPSCR().RMode() != Arm::FPSCR::RoundingMode::TowardsZero && !round_towards_zero) {
+        if (SoftwareFTZ(cb, block)) {
             DenormalsAreZero32(code, from, gpr_scratch);
         }
         code->cvtss2sd(from, from);
@@ -2120,7 +2431,7 @@ void EmitX64::EmitFPSingleToU32(IR::Block& block, IR::Inst* inst) {
         Xbyak::Xmm xmm_mask = reg_alloc.ScratchXmm();
         Xbyak::Reg32 gpr_mask = reg_alloc.ScratchGpr().cvt32();
 
-        if (block.Location().FPSCR().FTZ()) {
+        if (SoftwareFTZ(cb, block)) {
             DenormalsAreZero32(code, from, gpr_scratch);
         }
         code->cvtss2sd(from, from);
@@ -2157,9 +2468,13 @@ void EmitX64::EmitFPDoubleToS32(IR::Block& block, IR::Inst* inst) {
 
     // ARM saturates on conversion; this differs from x64 which returns a sentinel value.
 
-    if (block.Location().FPSCR().FTZ()) {
+    if (SoftwareFTZ(cb, block)) {
         DenormalsAreZero64(code, from, gpr_scratch.cvt64());
     }
+    if (HasHostFeature(HostFeature::SSE41)) {
+        DoubleToInt32SSE41(code, to, from, xmm_scratch, gpr_scratch.cvt64(), true, round_towards_zero);
+        return;
+    }
     // First time is to set flags
     if (round_towards_zero) {
         code->cvttsd2si(gpr_scratch, from); // 32 bit gpr
@@ -2192,8 +2507,13 @@ void EmitX64::EmitFPDoubleToU32(IR::Block& block, IR::Inst* inst) {
     // TODO: Use VCVTPD2UDQ when AVX512VL is available.
     // FIXME: Inexact exception not correctly signalled with the below code
 
-    if (block.Location().FPSCR().RMode() != Arm::FPSCR::RoundingMode::TowardsZero && !round_towards_zero) {
-        if (block.Location().FPSCR().FTZ()) {
+    if (HasHostFeature(HostFeature::SSE41)) {
+        if (SoftwareFTZ(cb, block)) {
+            DenormalsAreZero64(code, from, gpr_scratch.cvt64());
+        }
+        DoubleToInt32SSE41(code, to, from, xmm_scratch, gpr_scratch.cvt64(), false, round_towards_zero);
+    } else if (block.Location().FPSCR().RMode() != Arm::FPSCR::RoundingMode::TowardsZero && !round_towards_zero) {
+        if (SoftwareFTZ(cb, block)) {
             DenormalsAreZero64(code, from, gpr_scratch.cvt64());
         }
         ZeroIfNaN64(code, from, xmm_scratch);
@@ -2213,7 +2533,7 @@ void EmitX64::EmitFPDoubleToU32(IR::Block& block, IR::Inst* inst) {
         Xbyak::Xmm xmm_mask = reg_alloc.ScratchXmm();
         Xbyak::Reg32 gpr_mask = reg_alloc.ScratchGpr().cvt32();
 
-        if (block.Location().FPSCR().FTZ()) {
+        if (SoftwareFTZ(cb, block)) {
             DenormalsAreZero64(code, from, gpr_scratch.cvt64());
         }
         ZeroIfNaN64(code, from, xmm_scratch);
@@ -2309,9 +2629,76 @@ void EmitX64::EmitSetExclusive(IR::Block&, IR::Inst* inst) {
     code->mov(dword[r15 + offsetof(JitState, exclusive_address)], address);
 }
 
+static IR::Inst* NextInstruction(IR::Block& block, IR::Inst* inst) {
+    auto iter = std::next(IR::Block::iterator(inst));
+    return iter != block.end() ? &*iter : nullptr;
+}
+
+/**
+ * For big-endian accesses, IREmitter emits a byte reversal immediately after a memory read.
+ * Returns that byte reversal if it is the only use of `read_inst`, as it can then be folded into the load.
+ */
+static IR::Inst* GetFoldableByteReverseAfterRead(IR::Block& block, IR::Inst* read_inst, IR::Opcode byte_reverse_op) {
+    IR::Inst* next = NextInstruction(block, read_inst);
+    if (!next || next->GetOpcode() != byte_reverse_op || read_inst->UseCount() != 1)
+        return nullptr;
+    const IR::Value arg = next->GetArg(0);
+    return !arg.IsImmediate() && arg.GetInst() == read_inst ? next : nullptr;
+}
+
+/**
+ * For big-endian accesses, IREmitter emits a byte reversal immediately before a memory write.
+ * Returns that write if it is the only use of `byte_reverse_inst`, as the byte reversal can then be folded into the store.
+ */
+static IR::Inst* GetFoldableWriteAfterByteReverse(IR::Block& block, IR::Inst* byte_reverse_inst, IR::Opcode write_op) {
+    IR::Inst* next = NextInstruction(block, byte_reverse_inst);
+    if (!next || next->GetOpcode() != write_op || byte_reverse_inst->UseCount() != 1)
+        return nullptr;
+    const IR::Value arg = next->GetArg(1);
+    return !arg.IsImmediate() && arg.GetInst() == byte_reverse_inst ? next : nullptr;
+}
+
+/**
+ * Emits a page table lookup for an access of `byte_count` bytes at `vaddr`. On success rax holds the host
+ * pointer to the page and `page_offset` the offset within it; `page_index` may be the same register.
+ * Jumps to `abort` if the page has no host mapping, or if the access straddles a page boundary, as
+ * adjacent guest pages need not be adjacent in host memory.
+ */
+static void EmitPageTableLookup(BlockOfCode* code, const UserCallbacks& cb, Xbyak::Reg32 vaddr, Xbyak::Reg64 page_index, Xbyak::Reg64 page_offset, size_t byte_count, Xbyak::Label& abort) {
+    using namespace Xbyak::util;
+
+    const u32 page_size = 1u << cb.page_bits;
+
+    // The first level is indexed off the base pointer pinned in r14 by BlockOfCode::GenRunCode.
+    if (cb.page_directory) {
+        code->mov(page_index.cvt32(), vaddr);
+        code->shr(page_index.cvt32(), UserCallbacks::PAGE_DIRECTORY_SHIFT);
+        code->mov(rax, qword[r14 + page_index * 8]);
+        code->test(rax, rax);
+        code->jz(abort);
+        code->mov(page_index.cvt32(), vaddr);
+        code->shr(page_index.cvt32(), u8(cb.page_bits));
+        code->and_(page_index.cvt32(), u32((1u << (UserCallbacks::PAGE_DIRECTORY_SHIFT - cb.page_bits)) - 1));
+        code->mov(rax, qword[rax + page_index * 8]);
+    } else {
+        code->mov(page_index.cvt32(), vaddr);
+        code->shr(page_index.cvt32(), u8(cb.page_bits));
+        code->mov(rax, qword[r14 + page_index * 8]);
+    }
+    code->test(rax, rax);
+    code->jz(abort);
+    code->mov(page_offset.cvt32(), vaddr);
+    code->and_(page_offset.cvt32(), page_size - 1);
+    if (byte_count > 1) {
+        code->cmp(page_offset.cvt32(), u32(page_size - byte_count));
+        code->ja(abort);
+    }
+}
+
+/// If `byte_reverse_inst` is not null, it is folded into this read using MOVBE (See: GetFoldableByteReverseAfterRead).
 template <typename FunctionPointer>
-static void ReadMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, size_t bit_size, FunctionPointer fn) {
-    if (!cb.page_table) {
+static void ReadMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, size_t bit_size, FunctionPointer fn, IR::Inst* byte_reverse_inst = nullptr) {
+    if (!HasPageTable(cb)) {
         reg_alloc.HostCall(inst, inst->GetArg(0));
         code->CallFunction(fn);
         return;
@@ -2326,14 +2713,7 @@ static void ReadMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, U
 
     Xbyak::Label abort, end;
 
-    code->mov(rax, reinterpret_cast<u64>(cb.page_table));
-    code->mov(page_index.cvt32(), vaddr);
-    code->shr(page_index.cvt32(), 12);
-    code->mov(rax, qword[rax + page_index * 8]);
-    code->test(rax, rax);
-    code->jz(abort);
-    code->mov(page_offset.cvt32(), vaddr);
-    code->and_(page_offset.cvt32(), 4095);
+    EmitPageTableLookup(code, cb, vaddr, page_index, page_offset, bit_size / 8, abort);
     switch (bit_size) {
     case 8:
         code->movzx(result, code->byte[rax + page_offset]);
@@ -2342,10 +2722,18 @@ static void ReadMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, U
         code->movzx(result, word[rax + page_offset]);
         break;
     case 32:
-        code->mov(result.cvt32(), dword[rax + page_offset]);
+        if (byte_reverse_inst) {
+            code->movbe(result.cvt32(), dword[rax + page_offset]);
+        } else {
+            code->mov(result.cvt32(), dword[rax + page_offset]);
+        }
         break;
     case 64:
-        code->mov(result.cvt64(), qword[rax + page_offset]);
+        if (byte_reverse_inst) {
+            code->movbe(result.cvt64(), qword[rax + page_offset]);
+        } else {
+            code->mov(result.cvt64(), qword[rax + page_offset]);
+        }
         break;
     default:
         ASSERT_MSG(false, "Invalid bit_size");
@@ -2354,12 +2742,28 @@ static void ReadMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, U
     code->jmp(end);
     code->L(abort);
     code->call(code->GetMemoryReadCallback(bit_size));
+    if (byte_reverse_inst) {
+        if (bit_size == 64) {
+            code->bswap(result.cvt64());
+        } else {
+            code->bswap(result.cvt32());
+        }
+    }
     code->L(end);
+
+    if (byte_reverse_inst) {
+        // The byte reversal has been done; it now merely forwards the result of this read.
+        IR::Value read_value{inst};
+        byte_reverse_inst->ReplaceUsesWith(read_value);
+    }
 }
 
+/// If `byte_reverse` is set, the value written is the argument of the byte reversal that is the value
+/// argument of `inst`, and that byte reversal is folded into this write using MOVBE
+/// (See: GetFoldableWriteAfterByteReverse).
 template<typename FunctionPointer>
-static void WriteMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, size_t bit_size, FunctionPointer fn) {
-    if (!cb.page_table) {
+static void WriteMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, size_t bit_size, FunctionPointer fn, bool byte_reverse = false) {
+    if (!HasPageTable(cb)) {
         reg_alloc.HostCall(inst, inst->GetArg(0), inst->GetArg(1));
         code->CallFunction(fn);
         return;
@@ -2367,22 +2771,17 @@ static void WriteMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst,
 
     using namespace Xbyak::util;
 
+    const IR::Value value_arg = byte_reverse ? inst->GetArg(1).GetInst()->GetArg(0) : inst->GetArg(1);
+
     reg_alloc.ScratchGpr({ HostLoc::RAX });
     Xbyak::Reg32 vaddr = reg_alloc.UseScratchGpr(inst->GetArg(0), { ABI_PARAM1 }).cvt32();
-    Xbyak::Reg64 value = reg_alloc.UseScratchGpr(inst->GetArg(1), { ABI_PARAM2 });
+    Xbyak::Reg64 value = reg_alloc.UseScratchGpr(value_arg, { ABI_PARAM2 });
     Xbyak::Reg64 page_index = reg_alloc.ScratchGpr();
     Xbyak::Reg64 page_offset = reg_alloc.ScratchGpr();
 
     Xbyak::Label abort, end;
 
-    code->mov(rax, reinterpret_cast<u64>(cb.page_table));
-    code->mov(page_index.cvt32(), vaddr);
-    code->shr(page_index.cvt32(), 12);
-    code->mov(rax, qword[rax + page_index * 8]);
-    code->test(rax, rax);
-    code->jz(abort);
-    code->mov(page_offset.cvt32(), vaddr);
-    code->and_(page_offset.cvt32(), 4095);
+    EmitPageTableLookup(code, cb, vaddr, page_index, page_offset, bit_size / 8, abort);
     switch (bit_size) {
     case 8:
         code->mov(code->byte[rax + page_offset], value.cvt8());
@@ -2391,10 +2790,18 @@ static void WriteMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst,
         code->mov(word[rax + page_offset], value.cvt16());
         break;
     case 32:
-        code->mov(dword[rax + page_offset], value.cvt32());
+        if (byte_reverse) {
+            code->movbe(dword[rax + page_offset], value.cvt32());
+        } else {
+            code->mov(dword[rax + page_offset], value.cvt32());
+        }
         break;
     case 64:
-        code->mov(qword[rax + page_offset], value.cvt64());
+        if (byte_reverse) {
+            code->movbe(qword[rax + page_offset], value.cvt64());
+        } else {
+            code->mov(qword[rax + page_offset], value.cvt64());
+        }
         break;
     default:
         ASSERT_MSG(false, "Invalid bit_size");
@@ -2402,10 +2809,37 @@ static void WriteMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst,
     }
     code->jmp(end);
     code->L(abort);
+    if (byte_reverse) {
+        if (bit_size == 64) {
+            code->bswap(value.cvt64());
+        } else {
+            code->bswap(value.cvt32());
+        }
+    }
     code->call(code->GetMemoryWriteCallback(bit_size));
     code->L(end);
 }
 
+bool EmitX64::FoldByteReverseIntoWrite(IR::Block& block, IR::Inst* byte_reverse_inst, size_t bit_size) {
+    if (!HasPageTable(cb) || !HasHostFeature(HostFeature::MOVBE))
+        return false;
+
+    const IR::Opcode write_op = bit_size == 64 ? IR::Opcode::WriteMemory64 : IR::Opcode::WriteMemory32;
+    IR::Inst* write_inst = GetFoldableWriteAfterByteReverse(block, byte_reverse_inst, write_op);
+    if (!write_inst)
+        return false;
+
+    // The write is emitted here in place of the byte reversal, and then removed from the block.
+    if (bit_size == 64) {
+        WriteMemory(code, reg_alloc, write_inst, cb, 64, cb.MemoryWrite64, true);
+    } else {
+        WriteMemory(code, reg_alloc, write_inst, cb, 32, cb.MemoryWrite32, true);
+    }
+    byte_reverse_inst->DecrementRemainingUses();
+    EraseInstruction(block, write_inst);
+    return true;
+}
+
 void EmitX64::EmitReadMemory8(IR::Block&, IR::Inst* inst) {
     ReadMemory(code, reg_alloc, inst, cb, 8, cb.MemoryRead8);
 }
@@ -2414,12 +2848,14 @@ void EmitX64::EmitReadMemory16(IR::Block&, IR::Inst* inst) {
     ReadMemory(code, reg_alloc, inst, cb, 16, cb.MemoryRead16);
 }
 
-void EmitX64::EmitReadMemory32(IR::Block&, IR::Inst* inst) {
-    ReadMemory(code, reg_alloc, inst, cb, 32, cb.MemoryRead32);
+void EmitX64::EmitReadMemory32(IR::Block& block, IR::Inst* inst) {
+    IR::Inst* byte_reverse_inst = HasPageTable(cb) && HasHostFeature(HostFeature::MOVBE) ? GetFoldableByteReverseAfterRead(block, inst, IR::Opcode::ByteReverseWord) : nullptr;
+    ReadMemory(code, reg_alloc, inst, cb, 32, cb.MemoryRead32, byte_reverse_inst);
 }
 
-void EmitX64::EmitReadMemory64(IR::Block&, IR::Inst* inst) {
-    ReadMemory(code, reg_alloc, inst, cb, 64, cb.MemoryRead64);
+void EmitX64::EmitReadMemory64(IR::Block& block, IR::Inst* inst) {
+    IR::Inst* byte_reverse_inst = HasPageTable(cb) && HasHostFeature(HostFeature::MOVBE) ? GetFoldableByteReverseAfterRead(block, inst, IR::Opcode::ByteReverseDual) : nullptr;
+    ReadMemory(code, reg_alloc, inst, cb, 64, cb.MemoryRead64, byte_reverse_inst);
 }
 
 void EmitX64::EmitWriteMemory8(IR::Block&, IR::Inst* inst) {
@@ -2439,71 +2875,292 @@ void EmitX64::EmitWriteMemory64(IR::Block&, IR::Inst* inst) {
 }
 
 template <typename FunctionPointer>
-static void ExclusiveWrite(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, FunctionPointer fn) {
+static void ExclusiveWrite(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, size_t bit_size, FunctionPointer fn) {
     using namespace Xbyak::util;
     Xbyak::Label end;
 
-    reg_alloc.HostCall(nullptr, inst->GetArg(0), inst->GetArg(1));
+    if (!HasPageTable(cb)) {
+        reg_alloc.HostCall(nullptr, inst->GetArg(0), inst->GetArg(1));
+        Xbyak::Reg32 passed = reg_alloc.DefGpr(inst).cvt32();
+        Xbyak::Reg64 value_hi = bit_size == 64 ? reg_alloc.UseScratchGpr(inst->GetArg(2)) : Xbyak::Reg64{};
+        Xbyak::Reg64 value = code->ABI_PARAM2;
+        Xbyak::Reg32 tmp = code->ABI_RETURN.cvt32(); // Use one of the unusued HostCall registers.
+
+        code->mov(passed, u32(1));
+        code->cmp(code->byte[r15 + offsetof(JitState, exclusive_state)], u8(0));
+        code->je(end);
+        code->mov(tmp, code->ABI_PARAM1);
+        code->xor_(tmp, dword[r15 + offsetof(JitState, exclusive_address)]);
+        code->test(tmp, JitState::RESERVATION_GRANULE_MASK);
+        code->jne(end);
+        code->mov(code->byte[r15 + offsetof(JitState, exclusive_state)], u8(0));
+        if (bit_size == 64) {
+            code->mov(value.cvt32(), value.cvt32()); // zero extend to 64-bits
+            code->shl(value_hi, 32);
+            code->or_(value, value_hi);
+        }
+        code->CallFunction(fn);
+        code->xor_(passed, passed);
+        code->L(end);
+        return;
+    }
+
+    Xbyak::Label abort;
+
+    reg_alloc.ScratchGpr({ HostLoc::RAX });
+    Xbyak::Reg32 vaddr = reg_alloc.UseScratchGpr(inst->GetArg(0), { ABI_PARAM1 }).cvt32();
+    Xbyak::Reg64 value = reg_alloc.UseScratchGpr(inst->GetArg(1), { ABI_PARAM2 });
+    Xbyak::Reg64 value_hi = bit_size == 64 ? reg_alloc.UseScratchGpr(inst->GetArg(2)) : Xbyak::Reg64{};
     Xbyak::Reg32 passed = reg_alloc.DefGpr(inst).cvt32();
-    Xbyak::Reg32 tmp = code->ABI_RETURN.cvt32(); // Use one of the unusued HostCall registers.
+    Xbyak::Reg64 page_index = reg_alloc.ScratchGpr();
+    Xbyak::Reg64 page_offset = reg_alloc.ScratchGpr();
 
     code->mov(passed, u32(1));
     code->cmp(code->byte[r15 + offsetof(JitState, exclusive_state)], u8(0));
     code->je(end);
-    code->mov(tmp, code->ABI_PARAM1);
-    code->xor_(tmp, dword[r15 + offsetof(JitState, exclusive_address)]);
-    code->test(tmp, JitState::RESERVATION_GRANULE_MASK);
+    code->mov(page_index.cvt32(), vaddr);
+    code->xor_(page_index.cvt32(), dword[r15 + offsetof(JitState, exclusive_address)]);
+    code->test(page_index.cvt32(), JitState::RESERVATION_GRANULE_MASK);
     code->jne(end);
     code->mov(code->byte[r15 + offsetof(JitState, exclusive_state)], u8(0));
-    code->CallFunction(fn);
+    if (bit_size == 64) {
+        code->mov(value.cvt32(), value.cvt32()); // zero extend to 64-bits
+        code->shl(value_hi, 32);
+        code->or_(value, value_hi);
+    }
+
+    EmitPageTableLookup(code, cb, vaddr, page_index, page_offset, bit_size / 8, abort);
+    switch (bit_size) {
+    case 8:
+        code->mov(code->byte[rax + page_offset], value.cvt8());
+        break;
+    case 16:
+        code->mov(word[rax + page_offset], value.cvt16());
+        break;
+    case 32:
+        code->mov(dword[rax + page_offset], value.cvt32());
+        break;
+    case 64:
+        code->mov(qword[rax + page_offset], value.cvt64());
+        break;
+    default:
+        ASSERT_MSG(false, "Invalid bit_size");
+        break;
+    }
+    code->xor_(passed, passed);
+    code->jmp(end);
+    code->L(abort);
+    code->call(code->GetMemoryWriteCallback(bit_size));
     code->xor_(passed, passed);
     code->L(end);
 }
 
 void EmitX64::EmitExclusiveWriteMemory8(IR::Block&, IR::Inst* inst) {
-    ExclusiveWrite(code, reg_alloc, inst, cb.MemoryWrite8);
+    ExclusiveWrite(code, reg_alloc, inst, cb, 8, cb.MemoryWrite8);
 }
 
 void EmitX64::EmitExclusiveWriteMemory16(IR::Block&, IR::Inst* inst) {
-    ExclusiveWrite(code, reg_alloc, inst, cb.MemoryWrite16);
+    ExclusiveWrite(code, reg_alloc, inst, cb, 16, cb.MemoryWrite16);
 }
 
 void EmitX64::EmitExclusiveWriteMemory32(IR::Block&, IR::Inst* inst) {
-    ExclusiveWrite(code, reg_alloc, inst, cb.MemoryWrite32);
+    ExclusiveWrite(code, reg_alloc, inst, cb, 32, cb.MemoryWrite32);
 }
 
 void EmitX64::EmitExclusiveWriteMemory64(IR::Block&, IR::Inst* inst) {
+    ExclusiveWrite(code, reg_alloc, inst, cb, 64, cb.MemoryWrite64);
+}
+
+/// SWP and SWPB. With a page table the swap is a single XCHG, which is atomic with respect to other host threads.
+static void SwapMemory(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, size_t bit_size) {
     using namespace Xbyak::util;
-    Xbyak::Label end;
 
-    reg_alloc.HostCall(nullptr, inst->GetArg(0), inst->GetArg(1));
-    Xbyak::Reg32 passed = reg_alloc.DefGpr(inst).cvt32();
-    Xbyak::Reg64 value_hi = reg_alloc.UseScratchGpr(inst->GetArg(2));
-    Xbyak::Reg64 value = code->ABI_PARAM2;
-    Xbyak::Reg32 tmp = code->ABI_RETURN.cvt32(); // Use one of the unusued HostCall registers.
+    reg_alloc.ScratchGpr({ HostLoc::RAX });
+    Xbyak::Reg32 vaddr = reg_alloc.UseScratchGpr(inst->GetArg(0), { ABI_PARAM1 }).cvt32();
+    Xbyak::Reg32 value = reg_alloc.UseScratchGpr(inst->GetArg(1), { ABI_PARAM2 }).cvt32();
+    Xbyak::Reg32 result = reg_alloc.DefGpr(inst).cvt32();
 
-    code->mov(passed, u32(1));
-    code->cmp(code->byte[r15 + offsetof(JitState, exclusive_state)], u8(0));
-    code->je(end);
-    code->mov(tmp, code->ABI_PARAM1);
-    code->xor_(tmp, dword[r15 + offsetof(JitState, exclusive_address)]);
-    code->test(tmp, JitState::RESERVATION_GRANULE_MASK);
-    code->jne(end);
-    code->mov(code->byte[r15 + offsetof(JitState, exclusive_state)], u8(0));
-    code->mov(value.cvt32(), value.cvt32()); // zero extend to 64-bits
-    code->shl(value_hi, 32);
-    code->or_(value, value_hi);
-    code->CallFunction(cb.MemoryWrite64);
-    code->xor_(passed, passed);
+    Xbyak::Label abort, end;
+
+    if (HasPageTable(cb)) {
+        Xbyak::Reg64 page_index = reg_alloc.ScratchGpr();
+        Xbyak::Reg64 page_offset = reg_alloc.ScratchGpr();
+
+        EmitPageTableLookup(code, cb, vaddr, page_index, page_offset, bit_size / 8, abort);
+        code->mov(result, value);
+        if (bit_size == 8) {
+            code->xchg(code->byte[rax + page_offset], result.cvt8());
+            code->movzx(result, result.cvt8());
+        } else {
+            code->xchg(dword[rax + page_offset], result);
+        }
+        code->jmp(end);
+    }
+
+    // The callbacks preserve vaddr and value.
+    code->L(abort);
+    code->call(code->GetMemoryReadCallback(bit_size));
+    if (bit_size == 8) {
+        code->movzx(result, al);
+    } else {
+        code->mov(result, eax);
+    }
+    code->call(code->GetMemoryWriteCallback(bit_size));
     code->L(end);
 }
 
+void EmitX64::EmitSwapMemory8(IR::Block&, IR::Inst* inst) {
+    SwapMemory(code, reg_alloc, inst, cb, 8);
+}
+
+void EmitX64::EmitSwapMemory32(IR::Block&, IR::Inst* inst) {
+    SwapMemory(code, reg_alloc, inst, cb, 32);
+}
+
+/**
+ * Transfers `word_count` consecutive words of guest memory starting at the address in the first argument
+ * of `inst` to or from guest state, where the i-th word of guest state is at `jit_state_word(i)`.
+ * If `contiguous` is set, those words are adjacent in JitState and are copied with SSE moves.
+ * With a page table, this is a single page lookup unless the range has no host mapping or crosses a page.
+ */
+template <typename JitStateWordFn>
+static void BlockTransfer(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, bool is_write, size_t word_count, bool contiguous, JitStateWordFn jit_state_word) {
+    using namespace Xbyak::util;
+
+    ASSERT(word_count > 0);
+    const size_t byte_count = word_count * sizeof(u32);
+
+    reg_alloc.ScratchGpr({ HostLoc::RAX });
+    Xbyak::Reg32 vaddr = reg_alloc.UseScratchGpr(inst->GetArg(0), { ABI_PARAM1 }).cvt32();
+    Xbyak::Reg32 value = reg_alloc.ScratchGpr({ ABI_PARAM2 }).cvt32();
+
+    Xbyak::Label abort, end;
+
+    if (HasPageTable(cb)) {
+        Xbyak::Reg64 page_offset = reg_alloc.ScratchGpr();
+        Xbyak::Xmm xmm_scratch = reg_alloc.ScratchXmm();
+
+        EmitPageTableLookup(code, cb, vaddr, page_offset, page_offset, byte_count, abort);
+        code->add(rax, page_offset);
+
+        size_t offset = 0;
+        if (contiguous) {
+            for (; offset + 16 <= byte_count; offset += 16) {
+                if (is_write) {
+                    code->movups(xmm_scratch, xword[jit_state_word(offset / 4)]);
+                    code->movups(xword[rax + offset], xmm_scratch);
+                } else {
+                    code->movups(xmm_scratch, xword[rax + offset]);
+                    code->movups(xword[jit_state_word(offset / 4)], xmm_scratch);
+                }
+            }
+            for (; offset + 8 <= byte_count; offset += 8) {
+                if (is_write) {
+                    code->movq(xmm_scratch, qword[jit_state_word(offset / 4)]);
+                    code->movq(qword[rax + offset], xmm_scratch);
+                } else {
+                    code->movq(xmm_scratch, qword[rax + offset]);
+                    code->movq(qword[jit_state_word(offset / 4)], xmm_scratch);
+                }
+            }
+        }
+        for (; offset < byte_count; offset += 4) {
+            if (is_write) {
+                code->mov(value, dword[jit_state_word(offset / 4)]);
+                code->mov(dword[rax + offset], value);
+            } else {
+                code->mov(value, dword[rax + offset]);
+                code->mov(dword[jit_state_word(offset / 4)], value);
+            }
+        }
+
+        code->jmp(end);
+    }
+
+    // One word at a time through the memory callbacks.
+    code->L(abort);
+    for (size_t i = 0; i < word_count; i++) {
+        if (i != 0) {
+            code->add(vaddr, 4);
+        }
+        if (is_write) {
+            code->mov(value, dword[jit_state_word(i)]);
+            code->call(code->GetMemoryWriteCallback(32));
+        } else {
+            code->call(code->GetMemoryReadCallback(32));
+            code->mov(dword[jit_state_word(i)], eax);
+        }
+    }
+    code->L(end);
+}
+
+static void RegistersTransfer(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, bool is_write) {
+    using namespace Xbyak::util;
+
+    const u32 list = inst->GetArg(1).GetU32();
+    ASSERT(list != 0 && !Common::Bit<15>(list));
+
+    std::vector<size_t> regs;
+    for (size_t i = 0; i <= 14; i++) {
+        if (Common::Bit(i, list)) {
+            regs.push_back(i);
+        }
+    }
+
+    BlockTransfer(code, reg_alloc, inst, cb, is_write, regs.size(), false, [&regs](size_t i) {
+        return r15 + offsetof(JitState, Reg) + sizeof(u32) * regs[i];
+    });
+}
+
+static void ExtendedRegistersTransfer(BlockOfCode* code, RegAlloc& reg_alloc, IR::Inst* inst, UserCallbacks& cb, bool is_write) {
+    using namespace Xbyak::util;
+
+    const Arm::ExtReg first = inst->GetArg(1).GetExtRegRef();
+    const size_t count = inst->GetArg(2).GetU8();
+
+    // D<n> overlaps S<2n> and S<2n+1>, so both transfers are a run of consecutive words of JitState::ExtReg.
+    const bool is_double = Arm::IsDoubleExtReg(first);
+    const size_t first_word = is_double ? Arm::RegNumber(first) * 2 : Arm::RegNumber(first);
+    const size_t word_count = is_double ? count * 2 : count;
+
+    BlockTransfer(code, reg_alloc, inst, cb, is_write, word_count, true, [first_word](size_t i) {
+        return r15 + offsetof(JitState, ExtReg) + sizeof(u32) * (first_word + i);
+    });
+}
+
+void EmitX64::EmitReadMemoryToRegisters(IR::Block&, IR::Inst* inst) {
+    RegistersTransfer(code, reg_alloc, inst, cb, false);
+}
+
+void EmitX64::EmitWriteMemoryFromRegisters(IR::Block&, IR::Inst* inst) {
+    RegistersTransfer(code, reg_alloc, inst, cb, true);
+}
+
+void EmitX64::EmitReadMemoryToExtendedRegisters(IR::Block&, IR::Inst* inst) {
+    ExtendedRegistersTransfer(code, reg_alloc, inst, cb, false);
+}
+
+void EmitX64::EmitWriteMemoryFromExtendedRegisters(IR::Block&, IR::Inst* inst) {
+    ExtendedRegistersTransfer(code, reg_alloc, inst, cb, true);
+}
+
 void EmitX64::EmitAddCycles(size_t cycles) {
     using namespace Xbyak::util;
     ASSERT(cycles < std::numeric_limits<u32>::max());
     code->sub(qword[r15 + offsetof(JitState, cycles_remaining)], static_cast<u32>(cycles));
 }
 
+void EmitX64::EmitBlockProfileCounter(const IR::Block& block) {
+    using namespace Xbyak::util;
+
+    block_profiles.push_back({block.Location(), block.size(), 0});
+    u64* execution_count = &block_profiles.back().execution_count;
+
+    // No registers are live at the start of a block.
+    code->mov(rax, reinterpret_cast<u64>(execution_count));
+    code->inc(qword[rax]);
+}
+
 static Xbyak::Label EmitCond(BlockOfCode* code, Arm::Cond cond) {
     using namespace Xbyak::util;
 
@@ -2655,6 +3312,9 @@ void EmitX64::EmitTerminal(IR::Terminal terminal, IR::LocationDescriptor initial
     case 7:
         EmitTerminalCheckHalt(boost::get<IR::Term::CheckHalt>(terminal), initial_location);
         return;
+    case 8:
+        EmitTerminalIndirectBranchHint(boost::get<IR::Term::IndirectBranchHint>(terminal), initial_location);
+        return;
     default:
         ASSERT_MSG(false, "Invalid Terminal. Bad programmer.");
         return;
@@ -2669,9 +3329,14 @@ void EmitX64::EmitTerminalInterpret(IR::Term::Interpret terminal, IR::LocationDe
     code->mov(code->ABI_PARAM2, reinterpret_cast<u64>(jit_interface));
     code->mov(code->ABI_PARAM3, reinterpret_cast<u64>(cb.user_arg));
     code->mov(MJitStateReg(Arm::Reg::PC), code->ABI_PARAM1.cvt32());
-    code->SwitchMxcsrOnExit();
-    code->CallFunction(cb.InterpreterFallback);
-    code->ReturnFromRunCode(false); // TODO: Check cycles
+    if (cb.InterpreterFallback_is_mxcsr_agnostic) {
+        code->CallFunction(cb.InterpreterFallback);
+        code->ReturnFromRunCode(); // TODO: Check cycles
+    } else {
+        code->SwitchMxcsrOnExit();
+        code->CallFunction(cb.InterpreterFallback);
+        code->ReturnFromRunCode(false); // TODO: Check cycles
+    }
 }
 
 void EmitX64::EmitTerminalReturnToDispatch(IR::Term::ReturnToDispatch, IR::LocationDescriptor) {
@@ -2739,10 +3404,11 @@ void EmitX64::EmitTerminalLinkBlockFast(IR::Term::LinkBlockFast terminal, IR::Lo
     }
 }
 
-void EmitX64::EmitTerminalPopRSBHint(IR::Term::PopRSBHint, IR::LocationDescriptor) {
+/// Calculates the UniqueHash of the current location into rbx. Clobbers rcx.
+static void EmitCurrentLocationUniqueHash(BlockOfCode* code) {
     using namespace Xbyak::util;
 
-    // This calculation has to match up with IREmitter::PushRSB
+    // This calculation has to match up with IR::LocationDescriptor::UniqueHash
     code->mov(ebx, MJitStateCpsr());
     code->mov(ecx, MJitStateReg(Arm::Reg::PC));
     code->and_(ebx, u32((1 << 5) | (1 << 9)));
@@ -2750,14 +3416,56 @@ void EmitX64::EmitTerminalPopRSBHint(IR::Term::PopRSBHint, IR::LocationDescripto
     code->or_(ebx, dword[r15 + offsetof(JitState, FPSCR_mode)]);
     code->shl(rbx, 32);
     code->or_(rbx, rcx);
+}
 
-    code->mov(rax, reinterpret_cast<u64>(code->GetReturnFromRunCodeAddress()));
-    for (size_t i = 0; i < JitState::RSBSize; ++i) {
-        code->cmp(rbx, qword[r15 + offsetof(JitState, rsb_location_descriptors) + i * sizeof(u64)]);
-        code->cmove(rax, qword[r15 + offsetof(JitState, rsb_codeptrs) + i * sizeof(u64)]);
+void EmitX64::EmitTerminalPopRSBHint(IR::Term::PopRSBHint, IR::LocationDescriptor) {
+    using namespace Xbyak::util;
+
+    EmitCurrentLocationUniqueHash(code);
+
+    // Pop the top of the stack. The entry is popped regardless of whether the prediction was correct.
+    code->mov(edx, dword[r15 + offsetof(JitState, rsb_ptr)]);
+    code->lea(ecx, ptr[rdx - 1]);
+    code->and_(ecx, u32(cb.rsb_size - 1));
+    code->mov(dword[r15 + offsetof(JitState, rsb_ptr)], ecx);
+
+    Xbyak::Label miss;
+    code->cmp(rbx, qword[r15 + rdx * 8 + offsetof(JitState, rsb_location_descriptors)]);
+    code->jne(miss, code->T_NEAR);
+    code->add(qword[r15 + offsetof(JitState, rsb_hits)], 1);
+    // As with IndirectBranchHint, only chain into the predicted block while cycles remain. The check is made
+    // after the pop so that the stack stays balanced when we return to the dispatcher.
+    code->cmp(qword[r15 + offsetof(JitState, cycles_remaining)], 0);
+    code->jle(code->GetReturnFromRunCodeAddress());
+    code->jmp(qword[r15 + rdx * 8 + offsetof(JitState, rsb_codeptrs)]);
+    code->L(miss);
+    code->add(qword[r15 + offsetof(JitState, rsb_misses)], 1);
+    code->jmp(code->GetReturnFromRunCodeAddress());
+}
+
+void EmitX64::EmitTerminalIndirectBranchHint(IR::Term::IndirectBranchHint, IR::LocationDescriptor) {
+    using namespace Xbyak::util;
+
+    indirect_branch_caches.emplace_back();
+    const IndirectBranchCache* cache = &indirect_branch_caches.back();
+
+    code->cmp(qword[r15 + offsetof(JitState, cycles_remaining)], 0);
+    code->jle(code->GetReturnFromRunCodeAddress());
+
+    EmitCurrentLocationUniqueHash(code);
+
+    code->mov(rcx, reinterpret_cast<u64>(cache));
+    for (size_t i = 0; i < IndirectBranchCache::Size; i++) {
+        Xbyak::Label next;
+        code->cmp(rbx, qword[rcx + offsetof(IndirectBranchCache, location_descriptors) + i * sizeof(u64)]);
+        code->jne(next);
+        code->jmp(qword[rcx + offsetof(IndirectBranchCache, code_ptrs) + i * sizeof(CodePtr)]);
+        code->L(next);
     }
 
-    code->jmp(rax);
+    // Miss: The dispatcher fills in an entry once it has looked up the target (See: UpdateIndirectBranchCache).
+    code->mov(qword[r15 + offsetof(JitState, indirect_branch_cache_miss)], rcx);
+    code->jmp(code->GetReturnFromRunCodeAddress());
 }
 
 void EmitX64::EmitTerminalIf(IR::Term::If terminal, IR::LocationDescriptor initial_location) {
@@ -2801,7 +3509,22 @@ void EmitX64::Patch(IR::LocationDescriptor desc, CodePtr bb) {
     code->SetCodePtr(save_code_ptr);
 }
 
+void EmitX64::UpdateIndirectBranchCache(JitState& jit_state, IR::LocationDescriptor target, CodePtr target_code_ptr) {
+    if (jit_state.indirect_branch_cache_miss == 0)
+        return;
+
+    auto cache = reinterpret_cast<IndirectBranchCache*>(jit_state.indirect_branch_cache_miss);
+    jit_state.indirect_branch_cache_miss = 0;
+
+    const size_t index = cache->next_replacement;
+    cache->location_descriptors[index] = target.UniqueHash();
+    cache->code_ptrs[index] = target_code_ptr;
+    cache->next_replacement = (index + 1) % IndirectBranchCache::Size;
+}
+
 void EmitX64::ClearCache() {
+    indirect_branch_caches.clear();
+    block_profiles.clear();
     unique_hash_to_code_ptr.clear();
     patch_unique_hash_locations.clear();
     basic_blocks.clear();
@@ -6,13 +6,13 @@
 
 #pragma once
 
+#include <array>
+#include <deque>
 #include <unordered_map>
 #include <vector>
 
 #include <boost/optional.hpp>
 
-#include <xbyak_util.h>
-
 #include "backend_x64/reg_alloc.h"
 #include "dynarmic/callbacks.h"
 #include "frontend/ir/location_descriptor.h"
@@ -30,6 +30,7 @@ class Inst;
 namespace BackendX64 {
 
 class BlockOfCode;
+struct JitState;
 
 class EmitX64 final {
 public:
@@ -38,6 +39,13 @@ public:
         size_t size;      ///< Length in bytes of emitted code
     };
 
+    /// Execution counter of an emitted block (See: UserCallbacks::enable_block_profiling).
+    struct BlockProfile {
+        IR::LocationDescriptor descriptor;
+        size_t ir_instruction_count;
+        u64 execution_count;
+    };
+
     EmitX64(BlockOfCode* code, UserCallbacks cb, Jit* jit_interface);
 
     /**
@@ -49,6 +57,15 @@ public:
     /// Looks up an emitted host block in the cache.
     boost::optional<BlockDescriptor> GetBasicBlock(IR::LocationDescriptor descriptor) const;
 
+    /**
+     * Inserts `target` into the inline cache of the indirect branch that most recently missed,
+     * if there is one. This should be called by the dispatcher once it has looked up `target`.
+     */
+    void UpdateIndirectBranchCache(JitState& jit_state, IR::LocationDescriptor target, CodePtr target_code_ptr);
+
+    /// Execution counters of all emitted blocks. Empty unless block profiling is enabled.
+    const std::deque<BlockProfile>& GetBlockProfiles() const { return block_profiles; }
+
     /// Empties the cache.
     void ClearCache();
 
@@ -60,7 +77,10 @@ private:
 
     // Helpers
     void EmitAddCycles(size_t cycles);
+    void EmitBlockProfileCounter(const IR::Block& block);
     void EmitCondPrelude(const IR::Block& block);
+    /// Emits a byte reversal together with the memory write that follows it as a single MOVBE store, if possible.
+    bool FoldByteReverseIntoWrite(IR::Block& block, IR::Inst* byte_reverse_inst, size_t bit_size);
 
     // Terminal instruction emitters
     void EmitTerminal(IR::Terminal terminal, IR::LocationDescriptor initial_location);
@@ -69,12 +89,14 @@ private:
     void EmitTerminalLinkBlock(IR::Term::LinkBlock terminal, IR::LocationDescriptor initial_location);
     void EmitTerminalLinkBlockFast(IR::Term::LinkBlockFast terminal, IR::LocationDescriptor initial_location);
     void EmitTerminalPopRSBHint(IR::Term::PopRSBHint terminal, IR::LocationDescriptor initial_location);
+    void EmitTerminalIndirectBranchHint(IR::Term::IndirectBranchHint terminal, IR::LocationDescriptor initial_location);
     void EmitTerminalIf(IR::Term::If terminal, IR::LocationDescriptor initial_location);
     void EmitTerminalCheckHalt(IR::Term::CheckHalt terminal, IR::LocationDescriptor initial_location);
     void Patch(IR::LocationDescriptor desc, CodePtr bb);
 
     // Global CPU information
-    Xbyak::util::Cpu cpu_info;
+    bool HasHostFeature(u32 feature) const { return (host_features & feature) != 0; }
+    u32 host_features; ///< HostFeature flags supported by the host and not disabled by the user
 
     // Per-block state
     RegAlloc reg_alloc;
@@ -88,6 +110,19 @@ private:
     std::unordered_map<IR::LocationDescriptor, BlockDescriptor> basic_blocks;
     std::unordered_map<IR::LocationDescriptor, std::vector<CodePtr>> patch_jg_locations;
     std::unordered_map<IR::LocationDescriptor, std::vector<CodePtr>> patch_jmp_locations;
+
+    /// Recently seen targets of a single indirect branch site. Entries are replaced round-robin.
+    struct IndirectBranchCache {
+        static constexpr size_t Size = 4;
+        IndirectBranchCache() { location_descriptors.fill(~u64(0)); code_ptrs.fill(nullptr); }
+        std::array<u64, Size> location_descriptors;
+        std::array<CodePtr, Size> code_ptrs;
+        size_t next_replacement = 0;
+    };
+    // A std::deque is used as emitted code refers to its elements by address.
+    std::deque<IndirectBranchCache> indirect_branch_caches;
+    // As above, emitted code increments these counters by address.
+    std::deque<BlockProfile> block_profiles;
 };
 
 } // namespace BackendX64
@@ -4,6 +4,7 @@
  * General Public License version 2 or any later version.
  */
 
+#include "backend_x64/abi.h"
 #include "backend_x64/hostloc.h"
 
 namespace Dynarmic {
@@ -22,11 +23,11 @@ Xbyak::Xmm HostLocToXmm(HostLoc loc) {
 Xbyak::Address SpillToOpArg(HostLoc loc) {
     using namespace Xbyak::util;
 
-    static_assert(std::is_same<decltype(JitState::Spill[0]), u64&>::value, "Spill must be u64");
     DEBUG_ASSERT(HostLocIsSpill(loc));
 
+    // The spill area sits just above the shadow space of the frame (See: ABI_PushRegistersAndAdjustStack).
     size_t i = static_cast<size_t>(loc) - static_cast<size_t>(HostLoc::FirstSpill);
-    return qword[r15 + offsetof(JitState, Spill) + i * sizeof(u64)];
+    return qword[rsp + ABI_SHADOW_SPACE + i * sizeof(u64)];
 }
 
 } // namespace BackendX64
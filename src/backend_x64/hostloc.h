@@ -7,13 +7,16 @@
 
 #include <xbyak.h>
 
-#include "backend_x64/jitstate.h"
 #include "common/assert.h"
 #include "common/common_types.h"
 
 namespace Dynarmic {
 namespace BackendX64 {
 
+/// Spill slots live in the stack frame set up by BlockOfCode::GenRunCode (See: SpillToOpArg).
+constexpr size_t SpillCount = 64;
+constexpr size_t SpillFrameSize = SpillCount * sizeof(u64);
+
 enum class HostLoc {
     // Ordering of the registers is intentional. See also: HostLocToX64.
     RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15,
@@ -54,6 +57,7 @@ using HostLocList = std::initializer_list<HostLoc>;
 
 // RSP is preserved for function calls
 // R15 contains the JitState pointer
+// R14 contains the page table (or page directory) base pointer if there is one (See: RegAlloc::RegAlloc)
 const HostLocList any_gpr = {
     HostLoc::RAX,
     HostLoc::RBX,
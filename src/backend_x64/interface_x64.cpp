@@ -4,7 +4,12 @@
  * General Public License version 2 or any later version.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <unordered_map>
+
+#include <xmmintrin.h>
 
 #include <fmt/format.h>
 
@@ -15,9 +20,11 @@
 
 #include "backend_x64/block_of_code.h"
 #include "backend_x64/emit_x64.h"
+#include "backend_x64/ir_interpreter.h"
 #include "backend_x64/jitstate.h"
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/memory_pool.h"
 #include "common/scope_exit.h"
 #include "dynarmic/dynarmic.h"
 #include "frontend/ir/basic_block.h"
@@ -34,23 +41,74 @@ struct Jit::Impl {
             : block_of_code(callbacks)
             , jit_state()
             , emitter(&block_of_code, callbacks, jit)
+            , interpreter(&block_of_code, callbacks, jit)
             , callbacks(callbacks)
-    {}
+    {
+        statistics.stages.resize(NumStages);
+        statistics.stages[StageTranslate].name = "Translate";
+        statistics.stages[StageGetSetElimination].name = "GetSetElimination";
+        statistics.stages[StageDeadCodeElimination].name = "DeadCodeElimination";
+        statistics.stages[StageVerificationPass].name = "VerificationPass";
+        statistics.stages[StageEmit].name = "Emit";
+    }
 
     BlockOfCode block_of_code;
     JitState jit_state;
     EmitX64 emitter;
+    IRInterpreter interpreter;
     const UserCallbacks callbacks;
 
+    /// Blocks which have not yet been executed often enough to have host code emitted for them.
+    struct ColdBlock {
+        IR::Block ir_block;
+        size_t execution_count;
+    };
+    std::unordered_map<IR::LocationDescriptor, ColdBlock> cold_blocks;
+
+    /// Instructions of blocks which are emitted as soon as they are translated are allocated from here.
+    /// This is reset after each such emission, so that translation does not allocate in the steady state.
+    Common::Pool instruction_arena{sizeof(IR::Inst), 4096};
+
     bool clear_cache_required = false;
 
+    enum : size_t {
+        StageTranslate,
+        StageGetSetElimination,
+        StageDeadCodeElimination,
+        StageVerificationPass,
+        StageEmit,
+        NumStages,
+    };
+    Statistics statistics;
+
     size_t Execute(size_t cycle_count) {
         u32 pc = jit_state.Reg[15];
 
         IR::LocationDescriptor descriptor{pc, Arm::PSR{jit_state.Cpsr}, Arm::FPSCR{jit_state.FPSCR_mode}};
 
+        if (callbacks.cold_block_threshold != 0 && !emitter.GetBasicBlock(descriptor)) {
+            auto iter = cold_blocks.find(descriptor);
+            if (iter == cold_blocks.end()) {
+                iter = cold_blocks.emplace(descriptor, ColdBlock{TranslateBlock(descriptor), 0}).first;
+            }
+            if (iter->second.execution_count < callbacks.cold_block_threshold) {
+                iter->second.execution_count++;
+                // Only blocks with host code may be inserted into an inline cache.
+                jit_state.indirect_branch_cache_miss = 0;
+                return interpreter.Execute(iter->second.ir_block, jit_state);
+            }
+            // This block is now hot: GetBasicBlock emits host code from the cached IR.
+        }
+
         CodePtr code_ptr = GetBasicBlock(descriptor).code_ptr;
-        return block_of_code.RunCode(&jit_state, code_ptr, cycle_count);
+        emitter.UpdateIndirectBranchCache(jit_state, descriptor, code_ptr);
+
+        statistics.dispatcher_entries++;
+        const size_t cycles_executed = block_of_code.RunCode(&jit_state, code_ptr, cycle_count);
+        if (cycles_executed < cycle_count && !jit_state.halt_requested) {
+            statistics.dispatcher_exits++;
+        }
+        return cycles_executed;
     }
 
     std::string Disassemble(const IR::LocationDescriptor& descriptor) {
@@ -90,10 +148,34 @@ struct Jit::Impl {
         return result;
     }
 
+    std::vector<BlockProfileEntry> GetBlockProfile() const {
+        std::vector<BlockProfileEntry> result;
+        for (const auto& profile : emitter.GetBlockProfiles()) {
+            const auto block = emitter.GetBasicBlock(profile.descriptor);
+            ASSERT(block);
+            result.push_back({profile.descriptor.PC(), profile.execution_count, block->size, profile.ir_instruction_count});
+        }
+        std::stable_sort(result.begin(), result.end(), [](const BlockProfileEntry& a, const BlockProfileEntry& b) {
+            return a.execution_count > b.execution_count;
+        });
+        return result;
+    }
+
+    Statistics GetStatistics() const {
+        Statistics result = statistics;
+        result.code_cache_used = block_of_code.SpaceUsed();
+        result.code_cache_size = block_of_code.SpaceTotal();
+        result.rsb_hits = jit_state.rsb_hits;
+        result.rsb_misses = jit_state.rsb_misses;
+        return result;
+    }
+
     void ClearCache() {
         block_of_code.ClearCache();
         emitter.ClearCache();
+        cold_blocks.clear();
         jit_state.ResetRSB();
+        jit_state.indirect_branch_cache_miss = 0;
         clear_cache_required = false;
     }
 
@@ -103,11 +185,76 @@ private:
         if (block)
             return *block;
 
-        IR::Block ir_block = Arm::Translate(descriptor, callbacks.MemoryRead32);
-        Optimization::GetSetElimination(ir_block);
-        Optimization::DeadCodeElimination(ir_block);
-        Optimization::VerificationPass(ir_block);
-        return emitter.Emit(ir_block);
+        auto iter = cold_blocks.find(descriptor);
+        if (iter != cold_blocks.end()) {
+            auto result = EmitBlock(iter->second.ir_block);
+            cold_blocks.erase(iter);
+            return result;
+        }
+
+        SCOPE_EXIT({ instruction_arena.Reset(); });
+        IR::Block ir_block = TranslateBlock(descriptor, &instruction_arena);
+        return EmitBlock(ir_block);
+    }
+
+    /// Cold blocks outlive the translation of other blocks, so they are translated with no instruction_pool.
+    IR::Block TranslateBlock(IR::LocationDescriptor descriptor, Common::Pool* instruction_pool = nullptr) {
+        const auto start = std::chrono::steady_clock::now();
+        IR::Block ir_block = Arm::Translate(descriptor, callbacks.MemoryRead32, instruction_pool);
+        RecordStage(StageTranslate, start, 0, ir_block.size());
+
+        statistics.blocks_translated++;
+        statistics.guest_instructions_translated += ir_block.CycleCount();
+        CountInterpreterFallbacks(ir_block);
+
+        RunPass(StageGetSetElimination, ir_block, Optimization::GetSetElimination);
+        RunPass(StageDeadCodeElimination, ir_block, Optimization::DeadCodeElimination);
+        RunPass(StageVerificationPass, ir_block, Optimization::VerificationPass);
+        return ir_block;
+    }
+
+    EmitX64::BlockDescriptor EmitBlock(IR::Block& ir_block) {
+        // Emission may remove instructions from the block, e.g.: when it folds a byte reversal into a load.
+        const size_t ir_instructions_before = ir_block.size();
+        const auto start = std::chrono::steady_clock::now();
+        auto result = emitter.Emit(ir_block);
+        RecordStage(StageEmit, start, ir_instructions_before, ir_block.size());
+
+        statistics.blocks_compiled++;
+        statistics.host_code_bytes_emitted += result.size;
+        return result;
+    }
+
+    template <typename PassFn>
+    void RunPass(size_t stage, IR::Block& ir_block, PassFn pass) {
+        const size_t ir_instructions_before = ir_block.size();
+        const auto start = std::chrono::steady_clock::now();
+        pass(ir_block);
+        RecordStage(stage, start, ir_instructions_before, ir_block.size());
+    }
+
+    void RecordStage(size_t stage, std::chrono::steady_clock::time_point start, size_t ir_instructions_before, size_t ir_instructions_after) {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        statistics.stages[stage].nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        statistics.stages[stage].ir_instructions_before += ir_instructions_before;
+        statistics.stages[stage].ir_instructions_after += ir_instructions_after;
+    }
+
+    void CountInterpreterFallbacks(const IR::Block& ir_block) {
+        const auto count_fallback = [this](IR::LocationDescriptor location) {
+            statistics.interpreter_fallbacks[Arm::GetInstructionName(location, callbacks.MemoryRead32)]++;
+        };
+
+        for (const auto& inst : ir_block) {
+            if (inst.GetOpcode() == IR::Opcode::InterpretInstruction) {
+                count_fallback(ir_block.Location().SetPC(inst.GetArg(0).GetU32()));
+            }
+        }
+
+        const IR::Terminal terminal = ir_block.GetTerminal();
+        if (const auto* interpret = boost::get<IR::Term::Interpret>(&terminal)) {
+            count_fallback(interpret->next);
+        }
     }
 };
 
@@ -122,9 +269,18 @@ size_t Jit::Run(size_t cycle_count) {
 
     impl->jit_state.halt_requested = false;
 
+    // Memory accessors and MXCSR-agnostic callbacks are called with the guest MXCSR in effect. An exception
+    // thrown by one of them unwinds through JIT code without switching back, so we restore the host MXCSR here.
+    const u32 host_MXCSR = _mm_getcsr();
+
     size_t cycles_executed = 0;
-    while (cycles_executed < cycle_count && !impl->jit_state.halt_requested) {
-        cycles_executed += impl->Execute(cycle_count - cycles_executed);
+    try {
+        while (cycles_executed < cycle_count && !impl->jit_state.halt_requested) {
+            cycles_executed += impl->Execute(cycle_count - cycles_executed);
+        }
+    } catch (...) {
+        _mm_setcsr(host_MXCSR);
+        throw;
     }
 
     if (impl->clear_cache_required) {
@@ -179,16 +335,36 @@ u32 Jit::Cpsr() const {
     return impl->jit_state.Cpsr;
 }
 
+void Jit::SetCpsrWithModeSwitch(u32 value) {
+    impl->jit_state.SetCpsrWithModeSwitchUnchecked(value);
+}
+
+u32& Jit::Spsr() {
+    return impl->jit_state.Spsr;
+}
+
+u32 Jit::Spsr() const {
+    return impl->jit_state.Spsr;
+}
+
 u32 Jit::Fpscr() const {
     return impl->jit_state.Fpscr();
 }
 
 void Jit::SetFpscr(u32 value) const {
-    return impl->jit_state.SetFpscr(value);
+    return impl->jit_state.SetFpscr(value, impl->callbacks.fast_fp);
 }
 
 std::string Jit::Disassemble(const IR::LocationDescriptor& descriptor) {
     return impl->Disassemble(descriptor);
 }
 
+std::vector<BlockProfileEntry> Jit::GetBlockProfile() const {
+    return impl->GetBlockProfile();
+}
+
+Statistics Jit::GetStatistics() const {
+    return impl->GetStatistics();
+}
+
 } // namespace Dynarmic
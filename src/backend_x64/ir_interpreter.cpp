@@ -0,0 +1,1138 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2016 MerryMage
+ * This software may be used and distributed according to the terms of the GNU
+ * General Public License version 2 or any later version.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include <emmintrin.h>
+#include <xmmintrin.h>
+
+#include "backend_x64/block_of_code.h"
+#include "backend_x64/ir_interpreter.h"
+#include "common/assert.h"
+#include "common/bit_util.h"
+#include "frontend/arm/types.h"
+#include "frontend/ir/basic_block.h"
+#include "frontend/ir/microinstruction.h"
+#include "frontend/ir/opcodes.h"
+
+// The semantics implemented here MUST match those of the code emitted by EmitX64, including the
+// handling of FPSCR.FTZ and FPSCR.DN, saturation on floating-point conversions and page table accesses.
+
+namespace Dynarmic {
+namespace BackendX64 {
+
+template <typename To, typename From>
+static To BitCast(const From& source) {
+    static_assert(sizeof(To) == sizeof(From), "Size mismatch");
+    To dest;
+    std::memcpy(&dest, &source, sizeof(dest));
+    return dest;
+}
+
+static bool ConditionPassed(Arm::Cond cond, u32 cpsr) {
+    const bool n = Common::Bit<31>(cpsr);
+    const bool z = Common::Bit<30>(cpsr);
+    const bool c = Common::Bit<29>(cpsr);
+    const bool v = Common::Bit<28>(cpsr);
+
+    switch (cond) {
+    case Arm::Cond::EQ:
+        return z;
+    case Arm::Cond::NE:
+        return !z;
+    case Arm::Cond::CS:
+        return c;
+    case Arm::Cond::CC:
+        return !c;
+    case Arm::Cond::MI:
+        return n;
+    case Arm::Cond::PL:
+        return !n;
+    case Arm::Cond::VS:
+        return v;
+    case Arm::Cond::VC:
+        return !v;
+    case Arm::Cond::HI:
+        return c && !z;
+    case Arm::Cond::LS:
+        return !c || z;
+    case Arm::Cond::GE:
+        return n == v;
+    case Arm::Cond::LT:
+        return n != v;
+    case Arm::Cond::GT:
+        return !z && n == v;
+    case Arm::Cond::LE:
+        return z || n != v;
+    case Arm::Cond::AL:
+        return true;
+    default:
+        ASSERT_MSG(false, "Unknown cond %zu", static_cast<size_t>(cond));
+        return false;
+    }
+}
+
+// Shifts. These have ARM semantics: shift amounts above 31 are not masked.
+
+static std::pair<u32, bool> LogicalShiftLeft(u32 value, u8 shift, bool carry_in) {
+    if (shift == 0)
+        return {value, carry_in};
+    if (shift < 32)
+        return {value << shift, Common::Bit(32 - shift, value)};
+    if (shift == 32)
+        return {0, Common::Bit<0>(value)};
+    return {0, false};
+}
+
+static std::pair<u32, bool> LogicalShiftRight(u32 value, u8 shift, bool carry_in) {
+    if (shift == 0)
+        return {value, carry_in};
+    if (shift < 32)
+        return {value >> shift, Common::Bit(shift - 1, value)};
+    if (shift == 32)
+        return {0, Common::Bit<31>(value)};
+    return {0, false};
+}
+
+static std::pair<u32, bool> ArithmeticShiftRight(u32 value, u8 shift, bool carry_in) {
+    if (shift == 0)
+        return {value, carry_in};
+    if (shift < 32)
+        return {static_cast<u32>(static_cast<s32>(value) >> shift), Common::Bit(shift - 1, value)};
+    return {static_cast<u32>(static_cast<s32>(value) >> 31), Common::Bit<31>(value)};
+}
+
+static std::pair<u32, bool> RotateRight(u32 value, u8 shift, bool carry_in) {
+    if (shift == 0)
+        return {value, carry_in};
+    const size_t rotate = shift & 0x1F;
+    const u32 result = rotate == 0 ? value : (value >> rotate) | (value << (32 - rotate));
+    return {result, Common::Bit<31>(result)};
+}
+
+// Packed operations. `fn` calculates a single lane; its result is truncated to the lane width.
+
+template <typename T, typename Fn>
+static u32 PackedOp(u32 a, u32 b, Fn fn) {
+    constexpr size_t lane_bits = Common::BitSize<T>();
+    constexpr u32 lane_mask = (1u << lane_bits) - 1;
+
+    u32 result = 0;
+    for (size_t i = 0; i < 32; i += lane_bits) {
+        const int lane = fn(static_cast<T>(a >> i), static_cast<T>(b >> i));
+        result |= (static_cast<u32>(lane) & lane_mask) << i;
+    }
+    return result;
+}
+
+static int Saturate(int value, int min, int max) {
+    return std::max(min, std::min(value, max));
+}
+
+static u32 CountLeadingZeros(u32 value) {
+    u32 count = 0;
+    for (u32 bit = 1u << 31; bit != 0 && (value & bit) == 0; bit >>= 1)
+        count++;
+    return count;
+}
+
+// Memory accesses
+
+/// Returns the host address of an access that lies within a single host-mapped page, or nullptr.
+/// Accesses that straddle a page boundary use the callbacks, as adjacent pages need not be adjacent on the host.
+template <typename T>
+static u8* GetHostAddress(const UserCallbacks& cb, u32 vaddr) {
+    const u32 page_mask = (1u << cb.page_bits) - 1;
+    if ((vaddr & page_mask) > (page_mask + 1) - sizeof(T))
+        return nullptr;
+
+    u8* page = nullptr;
+    if (cb.page_directory) {
+        u8** table = (*cb.page_directory)[vaddr >> UserCallbacks::PAGE_DIRECTORY_SHIFT];
+        if (!table)
+            return nullptr;
+        const u32 table_mask = (1u << (UserCallbacks::PAGE_DIRECTORY_SHIFT - cb.page_bits)) - 1;
+        page = table[(vaddr >> cb.page_bits) & table_mask];
+    } else if (cb.page_table) {
+        page = (*cb.page_table)[vaddr >> cb.page_bits];
+    }
+    return page ? page + (vaddr & page_mask) : nullptr;
+}
+
+template <typename T>
+static T ReadMemory(const UserCallbacks& cb, u32 vaddr, T (*fn)(u32)) {
+    if (u8* host_address = GetHostAddress<T>(cb, vaddr)) {
+        T value;
+        std::memcpy(&value, host_address, sizeof(T));
+        return value;
+    }
+    return fn(vaddr);
+}
+
+template <typename T>
+static void WriteMemory(const UserCallbacks& cb, u32 vaddr, T value, void (*fn)(u32, T)) {
+    if (u8* host_address = GetHostAddress<T>(cb, vaddr)) {
+        std::memcpy(host_address, &value, sizeof(T));
+        return;
+    }
+    fn(vaddr, value);
+}
+
+/// Returns 0 if the write was performed, 1 otherwise.
+template <typename T>
+static u32 ExclusiveWriteMemory(const UserCallbacks& cb, JitState& jit_state, u32 vaddr, T value, void (*fn)(u32, T)) {
+    if (jit_state.exclusive_state == 0)
+        return 1;
+    if (((vaddr ^ jit_state.exclusive_address) & JitState::RESERVATION_GRANULE_MASK) != 0)
+        return 1;
+    jit_state.exclusive_state = 0;
+    WriteMemory(cb, vaddr, value, fn);
+    return 0;
+}
+
+// Floating-point helpers (See: EmitX64::EmitFP*)
+
+/// Floating-point operations within the lifetime of this object execute under the guest's MXCSR.
+class GuestMxcsrScope final {
+public:
+    explicit GuestMxcsrScope(JitState& jit_state) : jit_state(jit_state), host_MXCSR(_mm_getcsr()) {
+        _mm_setcsr(jit_state.guest_MXCSR);
+    }
+    ~GuestMxcsrScope() {
+        jit_state.guest_MXCSR = _mm_getcsr();
+        _mm_setcsr(host_MXCSR);
+    }
+
+private:
+    JitState& jit_state;
+    u32 host_MXCSR;
+};
+
+static bool IsDenormal32(u32 value) {
+    return (value & 0x7FFFFFFF) - 1 <= 0x007FFFFE;
+}
+
+static bool IsDenormal64(u64 value) {
+    return (value & 0x7FFFFFFFFFFFFFFF) - 1 <= 0x000FFFFFFFFFFFFE;
+}
+
+static void DenormalsAreZero32(JitState& jit_state, u32& value) {
+    if (IsDenormal32(value)) {
+        value = 0;
+        jit_state.FPSCR_IDC = 1 << 7;
+    }
+}
+
+static void DenormalsAreZero64(JitState& jit_state, u64& value) {
+    if (IsDenormal64(value)) {
+        value = 0;
+        jit_state.FPSCR_IDC = 1 << 7;
+    }
+}
+
+static void FlushToZero32(JitState& jit_state, u32& value) {
+    if (IsDenormal32(value)) {
+        value = 0;
+        jit_state.FPSCR_UFC = 1 << 3;
+    }
+}
+
+static void FlushToZero64(JitState& jit_state, u64& value) {
+    if (IsDenormal64(value)) {
+        value = 0;
+        jit_state.FPSCR_UFC = 1 << 3;
+    }
+}
+
+static void DefaultNaN32(u32& value) {
+    if ((value & 0x7FFFFFFF) > 0x7F800000) {
+        value = 0x7FC00000;
+    }
+}
+
+static void DefaultNaN64(u64& value) {
+    if ((value & 0x7FFFFFFFFFFFFFFF) > 0x7FF0000000000000) {
+        value = 0x7FF8000000000000;
+    }
+}
+
+template <typename Fn>
+static u32 FPOp32(bool ftz, bool dn, JitState& jit_state, u32 a, u32 b, Fn fn) {
+    if (ftz) {
+        DenormalsAreZero32(jit_state, a);
+        DenormalsAreZero32(jit_state, b);
+    }
+    u32 result = BitCast<u32>(fn(BitCast<float>(a), BitCast<float>(b)));
+    if (ftz) {
+        FlushToZero32(jit_state, result);
+    }
+    if (dn) {
+        DefaultNaN32(result);
+    }
+    return result;
+}
+
+template <typename Fn>
+static u64 FPOp64(bool ftz, bool dn, JitState& jit_state, u64 a, u64 b, Fn fn) {
+    if (ftz) {
+        DenormalsAreZero64(jit_state, a);
+        DenormalsAreZero64(jit_state, b);
+    }
+    u64 result = BitCast<u64>(fn(BitCast<double>(a), BitCast<double>(b)));
+    if (ftz) {
+        FlushToZero64(jit_state, result);
+    }
+    if (dn) {
+        DefaultNaN64(result);
+    }
+    return result;
+}
+
+static s32 ConvertDoubleToS32(double value, bool round_towards_zero) {
+    const __m128d xmm = _mm_set_sd(value);
+    return round_towards_zero ? _mm_cvttsd_si32(xmm) : _mm_cvtsd_si32(xmm);
+}
+
+/// Converts a double to a signed 32-bit integer, saturating. `value` must not be a NaN.
+static u32 SaturatingDoubleToS32(double value, bool round_towards_zero) {
+    // The first conversion is performed for its effect on the cumulative exception flags.
+    volatile s32 set_flags = ConvertDoubleToS32(value, round_towards_zero);
+    static_cast<void>(set_flags);
+
+    value = std::min(value, 2147483647.0);
+    value = std::max(value, -2147483648.0);
+    return static_cast<u32>(ConvertDoubleToS32(value, round_towards_zero));
+}
+
+/// Converts a double to an unsigned 32-bit integer, saturating. `value` must not be a NaN.
+static u32 SaturatingDoubleToU32(const IR::Block& block, double value, bool round_towards_zero) {
+    // SSE2 doesn't provide an unsigned conversion, so the range is shifted as appropriate.
+    if (block.Location().FPSCR().RMode() != Arm::FPSCR::RoundingMode::TowardsZero && !round_towards_zero) {
+        value += -2147483648.0;
+        return SaturatingDoubleToS32(value, false) + u32(2147483648u);
+    }
+
+    const bool out_of_signed_range = 2147483647.0 < value;
+    value += out_of_signed_range ? -2147483648.0 : 0.0;
+
+    volatile s32 set_flags = ConvertDoubleToS32(value, true);
+    static_cast<void>(set_flags);
+
+    value = std::min(value, 2147483647.0);
+    value = std::max(value, 0.0);
+    return static_cast<u32>(ConvertDoubleToS32(value, true)) + (out_of_signed_range ? u32(2147483648u) : 0);
+}
+
+static u32 FPCompareToNZCV(bool unordered, bool equal, bool less_than) {
+    if (unordered)
+        return 0x30000000;
+    if (equal)
+        return 0x60000000;
+    if (less_than)
+        return 0x80000000;
+    return 0x20000000;
+}
+
+IRInterpreter::IRInterpreter(BlockOfCode* code, UserCallbacks cb, Jit* jit_interface)
+    : code(code), cb(cb), jit_interface(jit_interface) {
+}
+
+size_t IRInterpreter::Execute(IR::Block& block, JitState& jit_state) {
+    const IR::LocationDescriptor location = block.Location();
+
+    u32 index = 0;
+    for (IR::Inst& inst : block) {
+        inst.SetIndex(index++);
+    }
+    results.assign(index, {});
+
+    if (block.GetCondition() != Arm::Cond::AL) {
+        ASSERT(block.HasConditionFailedLocation());
+
+        if (!ConditionPassed(block.GetCondition(), jit_state.Cpsr)) {
+            ExecuteLinkBlock(block.ConditionFailedLocation(), location, jit_state);
+            return block.ConditionFailedCycleCount();
+        }
+    }
+
+    for (const IR::Inst& inst : block) {
+        if (!ExecuteInst(block, &inst, jit_state)) {
+            // Only InterpretInstruction stops execution early; its third argument is the number of
+            // cycles executed up to and including the interpreted instruction.
+            return inst.GetArg(2).GetU32();
+        }
+    }
+
+    ExecuteTerminal(block.GetTerminal(), location, jit_state);
+    return block.CycleCount();
+}
+
+u64 IRInterpreter::Get(const IR::Value& arg) const {
+    if (arg.IsImmediate()) {
+        switch (arg.GetType()) {
+        case IR::Type::U1:
+            return arg.GetU1();
+        case IR::Type::U8:
+            return arg.GetU8();
+        case IR::Type::U32:
+            return arg.GetU32();
+        case IR::Type::U64:
+            return arg.GetU64();
+        default:
+            ASSERT_MSG(false, "Unexpected immediate type");
+            return 0;
+        }
+    }
+
+    return Result(arg.GetInst()).value;
+}
+
+const IRInterpreter::InstResult& IRInterpreter::Result(const IR::Inst* inst) const {
+    DEBUG_ASSERT(inst->GetIndex() < results.size());
+    const InstResult& result = results[inst->GetIndex()];
+    ASSERT_MSG(result.defined, "Use of a value before its definition");
+    return result;
+}
+
+IRInterpreter::InstResult& IRInterpreter::Def(const IR::Inst* inst) {
+    DEBUG_ASSERT(inst->GetIndex() < results.size());
+    InstResult& result = results[inst->GetIndex()];
+    result.defined = true;
+    return result;
+}
+
+bool IRInterpreter::ExecuteInst(const IR::Block& block, const IR::Inst* inst, JitState& jit_state) {
+    const auto arg_u1 = [&](size_t i) { return Get(inst->GetArg(i)) != 0; };
+    const auto arg_u8 = [&](size_t i) { return static_cast<u8>(Get(inst->GetArg(i))); };
+    const auto arg_u16 = [&](size_t i) { return static_cast<u16>(Get(inst->GetArg(i))); };
+    const auto arg_u32 = [&](size_t i) { return static_cast<u32>(Get(inst->GetArg(i))); };
+    const auto arg_u64 = [&](size_t i) { return Get(inst->GetArg(i)); };
+    const auto set_flag = [&](size_t bit, bool value) {
+        jit_state.Cpsr = (jit_state.Cpsr & ~(1u << bit)) | (static_cast<u32>(value) << bit);
+    };
+
+    switch (inst->GetOpcode()) {
+    case IR::Opcode::Identity:
+        Def(inst).value = arg_u64(0);
+        break;
+    case IR::Opcode::Breakpoint:
+        ASSERT_MSG(false, "Breakpoint");
+        break;
+
+    // ARM Context getters/setters
+    case IR::Opcode::GetRegister:
+        Def(inst).value = jit_state.Reg[static_cast<size_t>(inst->GetArg(0).GetRegRef())];
+        break;
+    case IR::Opcode::SetRegister:
+        jit_state.Reg[static_cast<size_t>(inst->GetArg(0).GetRegRef())] = arg_u32(1);
+        break;
+    case IR::Opcode::GetExtendedRegister32: {
+        Arm::ExtReg reg = inst->GetArg(0).GetExtRegRef();
+        ASSERT(Arm::IsSingleExtReg(reg));
+        size_t index = static_cast<size_t>(reg) - static_cast<size_t>(Arm::ExtReg::S0);
+        Def(inst).value = jit_state.ExtReg[index];
+        break;
+    }
+    case IR::Opcode::GetExtendedRegister64: {
+        Arm::ExtReg reg = inst->GetArg(0).GetExtRegRef();
+        ASSERT(Arm::IsDoubleExtReg(reg));
+        size_t index = static_cast<size_t>(reg) - static_cast<size_t>(Arm::ExtReg::D0);
+        Def(inst).value = jit_state.ExtReg[index * 2] | (u64(jit_state.ExtReg[index * 2 + 1]) << 32);
+        break;
+    }
+    case IR::Opcode::SetExtendedRegister32: {
+        Arm::ExtReg reg = inst->GetArg(0).GetExtRegRef();
+        ASSERT(Arm::IsSingleExtReg(reg));
+        size_t index = static_cast<size_t>(reg) - static_cast<size_t>(Arm::ExtReg::S0);
+        jit_state.ExtReg[index] = arg_u32(1);
+        break;
+    }
+    case IR::Opcode::SetExtendedRegister64: {
+        Arm::ExtReg reg = inst->GetArg(0).GetExtRegRef();
+        ASSERT(Arm::IsDoubleExtReg(reg));
+        size_t index = static_cast<size_t>(reg) - static_cast<size_t>(Arm::ExtReg::D0);
+        u64 value = arg_u64(1);
+        jit_state.ExtReg[index * 2] = static_cast<u32>(value);
+        jit_state.ExtReg[index * 2 + 1] = static_cast<u32>(value >> 32);
+        break;
+    }
+    case IR::Opcode::GetCpsr:
+        Def(inst).value = jit_state.Cpsr;
+        break;
+    case IR::Opcode::SetCpsr:
+        jit_state.Cpsr = arg_u32(0);
+        break;
+    case IR::Opcode::SetCpsrWithModeSwitch:
+        jit_state.SetCpsrWithModeSwitch(arg_u32(0));
+        break;
+    case IR::Opcode::GetSpsr:
+        Def(inst).value = jit_state.Spsr;
+        break;
+    case IR::Opcode::SetSpsr:
+        jit_state.Spsr = arg_u32(0);
+        break;
+    case IR::Opcode::GetNFlag:
+        Def(inst).value = Common::Bit<31>(jit_state.Cpsr);
+        break;
+    case IR::Opcode::SetNFlag:
+        set_flag(31, arg_u1(0));
+        break;
+    case IR::Opcode::GetZFlag:
+        Def(inst).value = Common::Bit<30>(jit_state.Cpsr);
+        break;
+    case IR::Opcode::SetZFlag:
+        set_flag(30, arg_u1(0));
+        break;
+    case IR::Opcode::GetCFlag:
+        Def(inst).value = Common::Bit<29>(jit_state.Cpsr);
+        break;
+    case IR::Opcode::SetCFlag:
+        set_flag(29, arg_u1(0));
+        break;
+    case IR::Opcode::GetVFlag:
+        Def(inst).value = Common::Bit<28>(jit_state.Cpsr);
+        break;
+    case IR::Opcode::SetVFlag:
+        set_flag(28, arg_u1(0));
+        break;
+    case IR::Opcode::OrQFlag:
+        jit_state.Cpsr |= static_cast<u32>(arg_u1(0)) << 27;
+        break;
+    case IR::Opcode::GetGEFlags:
+        Def(inst).value = (jit_state.Cpsr >> 16) & 0xF;
+        break;
+    case IR::Opcode::SetGEFlags:
+        jit_state.Cpsr = (jit_state.Cpsr & ~0x000F0000) | ((arg_u32(0) << 16) & 0x000F0000);
+        break;
+    case IR::Opcode::BXWritePC: {
+        u32 new_pc = arg_u32(0);
+        if (Common::Bit<0>(new_pc)) {
+            jit_state.Reg[15] = new_pc & 0xFFFFFFFE;
+            jit_state.Cpsr |= 1 << 5;
+        } else {
+            jit_state.Reg[15] = new_pc & 0xFFFFFFFC;
+            jit_state.Cpsr &= ~(1 << 5);
+        }
+        break;
+    }
+    case IR::Opcode::CallSupervisor:
+        cb.CallSVC(arg_u32(0));
+        break;
+    case IR::Opcode::InterpretInstruction: {
+        const u32 pc = arg_u32(0);
+        const u32 next_pc = arg_u32(1);
+
+        jit_state.Reg[15] = pc;
+        cb.InterpreterFallback(pc, jit_interface, cb.user_arg);
+
+        // The remainder of this block assumes that the interpreter continued at the next instruction
+        // without changing any of the state that the block was translated under.
+        const IR::LocationDescriptor location = block.Location();
+        return jit_state.Reg[15] == next_pc
+               && (jit_state.Cpsr & IR::LocationDescriptor::CPSR_MODE_MASK) == location.CPSR().Value()
+               && jit_state.FPSCR_mode == location.FPSCR().Value();
+    }
+    case IR::Opcode::GetFpscr:
+        Def(inst).value = jit_state.Fpscr();
+        break;
+    case IR::Opcode::SetFpscr:
+        jit_state.SetFpscr(arg_u32(0), cb.fast_fp);
+        break;
+    case IR::Opcode::GetFpscrNZCV:
+        Def(inst).value = jit_state.FPSCR_nzcv;
+        break;
+    case IR::Opcode::SetFpscrNZCV:
+        jit_state.FPSCR_nzcv = arg_u32(0);
+        break;
+
+    // Hints
+    case IR::Opcode::PushRSB: {
+        // The stack is kept in step with emitted code. There is no host code to predict here, so a
+        // hit on this entry merely returns to the dispatcher.
+        jit_state.rsb_ptr = (jit_state.rsb_ptr + 1) & static_cast<u32>(cb.rsb_size - 1);
+        jit_state.rsb_location_descriptors[jit_state.rsb_ptr] = arg_u64(0);
+        jit_state.rsb_codeptrs[jit_state.rsb_ptr] = reinterpret_cast<u64>(code->GetReturnFromRunCodeAddress());
+        break;
+    }
+
+    // Pseudo-operations
+    case IR::Opcode::GetCarryFromOp:
+        Def(inst).value = Result(inst->GetArg(0).GetInst()).carry;
+        break;
+    case IR::Opcode::GetOverflowFromOp:
+        Def(inst).value = Result(inst->GetArg(0).GetInst()).overflow;
+        break;
+    case IR::Opcode::GetGEFromOp:
+        Def(inst).value = Result(inst->GetArg(0).GetInst()).ge;
+        break;
+
+    // Calculations
+    case IR::Opcode::Pack2x32To1x64:
+        Def(inst).value = arg_u32(0) | (u64(arg_u32(1)) << 32);
+        break;
+    case IR::Opcode::LeastSignificantWord:
+        Def(inst).value = static_cast<u32>(arg_u64(0));
+        break;
+    case IR::Opcode::MostSignificantWord: {
+        u64 value = arg_u64(0);
+        InstResult& result = Def(inst);
+        result.value = value >> 32;
+        result.carry = Common::Bit<31>(value);
+        break;
+    }
+    case IR::Opcode::LeastSignificantHalf:
+        Def(inst).value = static_cast<u16>(arg_u32(0));
+        break;
+    case IR::Opcode::LeastSignificantByte:
+        Def(inst).value = static_cast<u8>(arg_u32(0));
+        break;
+    case IR::Opcode::MostSignificantBit:
+        Def(inst).value = Common::Bit<31>(arg_u32(0));
+        break;
+    case IR::Opcode::IsZero:
+        Def(inst).value = arg_u32(0) == 0;
+        break;
+    case IR::Opcode::IsZero64:
+        Def(inst).value = arg_u64(0) == 0;
+        break;
+    case IR::Opcode::LogicalShiftLeft:
+    case IR::Opcode::LogicalShiftRight:
+    case IR::Opcode::ArithmeticShiftRight:
+    case IR::Opcode::RotateRight: {
+        using ShiftFn = std::pair<u32, bool>(*)(u32, u8, bool);
+        ShiftFn fn = inst->GetOpcode() == IR::Opcode::LogicalShiftLeft ? &LogicalShiftLeft
+                   : inst->GetOpcode() == IR::Opcode::LogicalShiftRight ? &LogicalShiftRight
+                   : inst->GetOpcode() == IR::Opcode::ArithmeticShiftRight ? &ArithmeticShiftRight
+                   : &RotateRight;
+        auto shifted = fn(arg_u32(0), arg_u8(1), arg_u1(2));
+        InstResult& result = Def(inst);
+        result.value = shifted.first;
+        result.carry = shifted.second;
+        break;
+    }
+    case IR::Opcode::LogicalShiftRight64: {
+        u8 shift = arg_u8(1);
+        ASSERT_MSG(shift < 64, "shift width clamping is not implemented");
+        Def(inst).value = arg_u64(0) >> shift;
+        break;
+    }
+    case IR::Opcode::RotateRightExtended: {
+        u32 value = arg_u32(0);
+        InstResult& result = Def(inst);
+        result.value = (value >> 1) | (static_cast<u32>(arg_u1(1)) << 31);
+        result.carry = Common::Bit<0>(value);
+        break;
+    }
+    case IR::Opcode::AddWithCarry:
+    case IR::Opcode::SubWithCarry: {
+        u32 a = arg_u32(0);
+        u32 b = inst->GetOpcode() == IR::Opcode::AddWithCarry ? arg_u32(1) : ~arg_u32(1);
+        u64 sum = u64(a) + u64(b) + u64(arg_u1(2));
+        u32 value = static_cast<u32>(sum);
+        InstResult& result = Def(inst);
+        result.value = value;
+        result.carry = Common::Bit<32>(sum);
+        result.overflow = Common::Bit<31>((a ^ value) & (b ^ value));
+        break;
+    }
+    case IR::Opcode::Add64:
+        Def(inst).value = arg_u64(0) + arg_u64(1);
+        break;
+    case IR::Opcode::Sub64:
+        Def(inst).value = arg_u64(0) - arg_u64(1);
+        break;
+    case IR::Opcode::Mul:
+        Def(inst).value = static_cast<u32>(arg_u32(0) * arg_u32(1));
+        break;
+    case IR::Opcode::Mul64:
+        Def(inst).value = arg_u64(0) * arg_u64(1);
+        break;
+    case IR::Opcode::And:
+        Def(inst).value = arg_u32(0) & arg_u32(1);
+        break;
+    case IR::Opcode::Eor:
+        Def(inst).value = arg_u32(0) ^ arg_u32(1);
+        break;
+    case IR::Opcode::Or:
+        Def(inst).value = arg_u32(0) | arg_u32(1);
+        break;
+    case IR::Opcode::Not:
+        Def(inst).value = ~arg_u32(0);
+        break;
+    case IR::Opcode::SignExtendWordToLong:
+        Def(inst).value = static_cast<u64>(static_cast<s64>(static_cast<s32>(arg_u32(0))));
+        break;
+    case IR::Opcode::SignExtendHalfToWord:
+        Def(inst).value = static_cast<u32>(static_cast<s32>(static_cast<s16>(arg_u16(0))));
+        break;
+    case IR::Opcode::SignExtendByteToWord:
+        Def(inst).value = static_cast<u32>(static_cast<s32>(static_cast<s8>(arg_u8(0))));
+        break;
+    case IR::Opcode::ZeroExtendWordToLong:
+        Def(inst).value = arg_u32(0);
+        break;
+    case IR::Opcode::ZeroExtendHalfToWord:
+        Def(inst).value = arg_u16(0);
+        break;
+    case IR::Opcode::ZeroExtendByteToWord:
+        Def(inst).value = arg_u8(0);
+        break;
+    case IR::Opcode::ByteReverseWord: {
+        u32 value = arg_u32(0);
+        Def(inst).value = (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+        break;
+    }
+    case IR::Opcode::ByteReverseHalf: {
+        u16 value = arg_u16(0);
+        Def(inst).value = static_cast<u16>((value >> 8) | (value << 8));
+        break;
+    }
+    case IR::Opcode::ByteReverseDual: {
+        u64 value = arg_u64(0);
+        u64 result = 0;
+        for (size_t i = 0; i < 8; i++) {
+            result = (result << 8) | ((value >> (i * 8)) & 0xFF);
+        }
+        Def(inst).value = result;
+        break;
+    }
+    case IR::Opcode::CountLeadingZeros:
+        Def(inst).value = CountLeadingZeros(arg_u32(0));
+        break;
+
+    // Saturated instructions
+    case IR::Opcode::SignedSaturatedAdd:
+    case IR::Opcode::SignedSaturatedSub: {
+        s64 a = static_cast<s32>(arg_u32(0));
+        s64 b = static_cast<s32>(arg_u32(1));
+        s64 value = inst->GetOpcode() == IR::Opcode::SignedSaturatedAdd ? a + b : a - b;
+        InstResult& result = Def(inst);
+        result.overflow = value > 0x7FFFFFFF || value < -0x80000000LL;
+        result.value = static_cast<u32>(result.overflow ? (a < 0 ? 0x80000000 : 0x7FFFFFFF) : value);
+        break;
+    }
+
+    // Packed instructions
+    case IR::Opcode::PackedAddU8: {
+        u32 a = arg_u32(0);
+        u32 b = arg_u32(1);
+        InstResult& result = Def(inst);
+        result.value = PackedOp<u8>(a, b, [](u8 x, u8 y) { return x + y; });
+        result.ge = 0;
+        for (size_t i = 0; i < 4; i++) {
+            if (((a >> (i * 8)) & 0xFF) + ((b >> (i * 8)) & 0xFF) > 0xFF)
+                result.ge |= 1 << i;
+        }
+        break;
+    }
+    case IR::Opcode::PackedSubU8: {
+        u32 a = arg_u32(0);
+        u32 b = arg_u32(1);
+        InstResult& result = Def(inst);
+        result.value = PackedOp<u8>(a, b, [](u8 x, u8 y) { return x - y; });
+        result.ge = 0;
+        for (size_t i = 0; i < 4; i++) {
+            if (((a >> (i * 8)) & 0xFF) >= ((b >> (i * 8)) & 0xFF))
+                result.ge |= 1 << i;
+        }
+        break;
+    }
+    case IR::Opcode::PackedHalvingAddU8:
+        Def(inst).value = PackedOp<u8>(arg_u32(0), arg_u32(1), [](u8 x, u8 y) { return (x + y) >> 1; });
+        break;
+    case IR::Opcode::PackedHalvingAddS8:
+        Def(inst).value = PackedOp<s8>(arg_u32(0), arg_u32(1), [](s8 x, s8 y) { return (x + y) >> 1; });
+        break;
+    case IR::Opcode::PackedHalvingSubU8:
+        Def(inst).value = PackedOp<u8>(arg_u32(0), arg_u32(1), [](u8 x, u8 y) { return (x - y) >> 1; });
+        break;
+    case IR::Opcode::PackedHalvingAddU16:
+        Def(inst).value = PackedOp<u16>(arg_u32(0), arg_u32(1), [](u16 x, u16 y) { return (x + y) >> 1; });
+        break;
+    case IR::Opcode::PackedHalvingAddS16:
+        Def(inst).value = PackedOp<s16>(arg_u32(0), arg_u32(1), [](s16 x, s16 y) { return (x + y) >> 1; });
+        break;
+    case IR::Opcode::PackedHalvingSubU16:
+        Def(inst).value = PackedOp<u16>(arg_u32(0), arg_u32(1), [](u16 x, u16 y) { return (x - y) >> 1; });
+        break;
+    case IR::Opcode::PackedSaturatedAddU8:
+        Def(inst).value = PackedOp<u8>(arg_u32(0), arg_u32(1), [](u8 x, u8 y) { return Saturate(x + y, 0, 0xFF); });
+        break;
+    case IR::Opcode::PackedSaturatedAddS8:
+        Def(inst).value = PackedOp<s8>(arg_u32(0), arg_u32(1), [](s8 x, s8 y) { return Saturate(x + y, -0x80, 0x7F); });
+        break;
+    case IR::Opcode::PackedSaturatedSubU8:
+        Def(inst).value = PackedOp<u8>(arg_u32(0), arg_u32(1), [](u8 x, u8 y) { return Saturate(x - y, 0, 0xFF); });
+        break;
+    case IR::Opcode::PackedSaturatedSubS8:
+        Def(inst).value = PackedOp<s8>(arg_u32(0), arg_u32(1), [](s8 x, s8 y) { return Saturate(x - y, -0x80, 0x7F); });
+        break;
+    case IR::Opcode::PackedSaturatedAddU16:
+        Def(inst).value = PackedOp<u16>(arg_u32(0), arg_u32(1), [](u16 x, u16 y) { return Saturate(x + y, 0, 0xFFFF); });
+        break;
+    case IR::Opcode::PackedSaturatedAddS16:
+        Def(inst).value = PackedOp<s16>(arg_u32(0), arg_u32(1), [](s16 x, s16 y) { return Saturate(x + y, -0x8000, 0x7FFF); });
+        break;
+    case IR::Opcode::PackedSaturatedSubU16:
+        Def(inst).value = PackedOp<u16>(arg_u32(0), arg_u32(1), [](u16 x, u16 y) { return Saturate(x - y, 0, 0xFFFF); });
+        break;
+    case IR::Opcode::PackedSaturatedSubS16:
+        Def(inst).value = PackedOp<s16>(arg_u32(0), arg_u32(1), [](s16 x, s16 y) { return Saturate(x - y, -0x8000, 0x7FFF); });
+        break;
+
+    // Floating-point operations
+    case IR::Opcode::TransferToFP32:
+    case IR::Opcode::TransferFromFP32:
+        Def(inst).value = arg_u32(0);
+        break;
+    case IR::Opcode::TransferToFP64:
+    case IR::Opcode::TransferFromFP64:
+        Def(inst).value = arg_u64(0);
+        break;
+    case IR::Opcode::FPAbs32:
+        Def(inst).value = arg_u32(0) & 0x7FFFFFFF;
+        break;
+    case IR::Opcode::FPAbs64:
+        Def(inst).value = arg_u64(0) & 0x7FFFFFFFFFFFFFFF;
+        break;
+    case IR::Opcode::FPNeg32:
+        Def(inst).value = arg_u32(0) ^ 0x80000000;
+        break;
+    case IR::Opcode::FPNeg64:
+        Def(inst).value = arg_u64(0) ^ 0x8000000000000000;
+        break;
+    case IR::Opcode::FPAdd32:
+    case IR::Opcode::FPAdd64:
+    case IR::Opcode::FPCompare32:
+    case IR::Opcode::FPCompare64:
+    case IR::Opcode::FPDiv32:
+    case IR::Opcode::FPDiv64:
+    case IR::Opcode::FPMul32:
+    case IR::Opcode::FPMul64:
+    case IR::Opcode::FPSqrt32:
+    case IR::Opcode::FPSqrt64:
+    case IR::Opcode::FPSub32:
+    case IR::Opcode::FPSub64:
+    case IR::Opcode::FPSingleToDouble:
+    case IR::Opcode::FPDoubleToSingle:
+    case IR::Opcode::FPSingleToU32:
+    case IR::Opcode::FPSingleToS32:
+    case IR::Opcode::FPDoubleToU32:
+    case IR::Opcode::FPDoubleToS32:
+    case IR::Opcode::FPU32ToSingle:
+    case IR::Opcode::FPS32ToSingle:
+    case IR::Opcode::FPU32ToDouble:
+    case IR::Opcode::FPS32ToDouble:
+        ExecuteFPInst(block, inst, jit_state);
+        break;
+
+    // Memory access
+    case IR::Opcode::ClearExclusive:
+        jit_state.exclusive_state = 0;
+        break;
+    case IR::Opcode::SetExclusive:
+        ASSERT(inst->GetArg(1).IsImmediate());
+        jit_state.exclusive_state = 1;
+        jit_state.exclusive_address = arg_u32(0);
+        break;
+    case IR::Opcode::ReadMemory8:
+        Def(inst).value = ReadMemory(cb, arg_u32(0), cb.MemoryRead8);
+        break;
+    case IR::Opcode::ReadMemory16:
+        Def(inst).value = ReadMemory(cb, arg_u32(0), cb.MemoryRead16);
+        break;
+    case IR::Opcode::ReadMemory32:
+        Def(inst).value = ReadMemory(cb, arg_u32(0), cb.MemoryRead32);
+        break;
+    case IR::Opcode::ReadMemory64:
+        Def(inst).value = ReadMemory(cb, arg_u32(0), cb.MemoryRead64);
+        break;
+    case IR::Opcode::WriteMemory8:
+        WriteMemory(cb, arg_u32(0), arg_u8(1), cb.MemoryWrite8);
+        break;
+    case IR::Opcode::WriteMemory16:
+        WriteMemory(cb, arg_u32(0), arg_u16(1), cb.MemoryWrite16);
+        break;
+    case IR::Opcode::WriteMemory32:
+        WriteMemory(cb, arg_u32(0), arg_u32(1), cb.MemoryWrite32);
+        break;
+    case IR::Opcode::WriteMemory64:
+        WriteMemory(cb, arg_u32(0), arg_u64(1), cb.MemoryWrite64);
+        break;
+    case IR::Opcode::ExclusiveWriteMemory8:
+        Def(inst).value = ExclusiveWriteMemory(cb, jit_state, arg_u32(0), arg_u8(1), cb.MemoryWrite8);
+        break;
+    case IR::Opcode::ExclusiveWriteMemory16:
+        Def(inst).value = ExclusiveWriteMemory(cb, jit_state, arg_u32(0), arg_u16(1), cb.MemoryWrite16);
+        break;
+    case IR::Opcode::ExclusiveWriteMemory32:
+        Def(inst).value = ExclusiveWriteMemory(cb, jit_state, arg_u32(0), arg_u32(1), cb.MemoryWrite32);
+        break;
+    case IR::Opcode::ExclusiveWriteMemory64:
+        Def(inst).value = ExclusiveWriteMemory(cb, jit_state, arg_u32(0), arg_u32(1) | (u64(arg_u32(2)) << 32), cb.MemoryWrite64);
+        break;
+    case IR::Opcode::SwapMemory8:
+        Def(inst).value = ReadMemory(cb, arg_u32(0), cb.MemoryRead8);
+        WriteMemory(cb, arg_u32(0), arg_u8(1), cb.MemoryWrite8);
+        break;
+    case IR::Opcode::SwapMemory32:
+        Def(inst).value = ReadMemory(cb, arg_u32(0), cb.MemoryRead32);
+        WriteMemory(cb, arg_u32(0), arg_u32(1), cb.MemoryWrite32);
+        break;
+    case IR::Opcode::ReadMemoryToRegisters:
+    case IR::Opcode::WriteMemoryFromRegisters: {
+        const bool is_write = inst->GetOpcode() == IR::Opcode::WriteMemoryFromRegisters;
+        const u32 list = arg_u32(1);
+        u32 vaddr = arg_u32(0);
+        for (size_t i = 0; i <= 14; i++) {
+            if (Common::Bit(i, list)) {
+                if (is_write) {
+                    WriteMemory(cb, vaddr, jit_state.Reg[i], cb.MemoryWrite32);
+                } else {
+                    jit_state.Reg[i] = ReadMemory(cb, vaddr, cb.MemoryRead32);
+                }
+                vaddr += 4;
+            }
+        }
+        break;
+    }
+    case IR::Opcode::ReadMemoryToExtendedRegisters:
+    case IR::Opcode::WriteMemoryFromExtendedRegisters: {
+        const bool is_write = inst->GetOpcode() == IR::Opcode::WriteMemoryFromExtendedRegisters;
+        const Arm::ExtReg first = inst->GetArg(1).GetExtRegRef();
+        const size_t count = inst->GetArg(2).GetU8();
+        // D<n> overlaps S<2n> and S<2n+1>, so both are a run of consecutive words of ExtReg.
+        const bool is_double = Arm::IsDoubleExtReg(first);
+        const size_t first_word = is_double ? Arm::RegNumber(first) * 2 : Arm::RegNumber(first);
+        const size_t word_count = is_double ? count * 2 : count;
+        u32 vaddr = arg_u32(0);
+        for (size_t i = first_word; i < first_word + word_count; i++) {
+            if (is_write) {
+                WriteMemory(cb, vaddr, jit_state.ExtReg[i], cb.MemoryWrite32);
+            } else {
+                jit_state.ExtReg[i] = ReadMemory(cb, vaddr, cb.MemoryRead32);
+            }
+            vaddr += 4;
+        }
+        break;
+    }
+
+    default:
+        ASSERT_MSG(false, "Invalid opcode %zu", static_cast<size_t>(inst->GetOpcode()));
+        break;
+    }
+
+    return true;
+}
+
+void IRInterpreter::ExecuteFPInst(const IR::Block& block, const IR::Inst* inst, JitState& jit_state) {
+    // See: UserCallbacks::fast_fp
+    const bool ftz = !cb.fast_fp && block.Location().FPSCR().FTZ();
+    const bool dn = !cb.fast_fp && block.Location().FPSCR().DN();
+
+    GuestMxcsrScope mxcsr_scope{jit_state};
+
+    switch (inst->GetOpcode()) {
+    case IR::Opcode::FPAdd32:
+        Def(inst).value = FPOp32(ftz, dn, jit_state, static_cast<u32>(Get(inst->GetArg(0))), static_cast<u32>(Get(inst->GetArg(1))), [](float a, float b) { return a + b; });
+        break;
+    case IR::Opcode::FPAdd64:
+        Def(inst).value = FPOp64(ftz, dn, jit_state, Get(inst->GetArg(0)), Get(inst->GetArg(1)), [](double a, double b) { return a + b; });
+        break;
+    case IR::Opcode::FPDiv32:
+        Def(inst).value = FPOp32(ftz, dn, jit_state, static_cast<u32>(Get(inst->GetArg(0))), static_cast<u32>(Get(inst->GetArg(1))), [](float a, float b) { return a / b; });
+        break;
+    case IR::Opcode::FPDiv64:
+        Def(inst).value = FPOp64(ftz, dn, jit_state, Get(inst->GetArg(0)), Get(inst->GetArg(1)), [](double a, double b) { return a / b; });
+        break;
+    case IR::Opcode::FPMul32:
+        Def(inst).value = FPOp32(ftz, dn, jit_state, static_cast<u32>(Get(inst->GetArg(0))), static_cast<u32>(Get(inst->GetArg(1))), [](float a, float b) { return a * b; });
+        break;
+    case IR::Opcode::FPMul64:
+        Def(inst).value = FPOp64(ftz, dn, jit_state, Get(inst->GetArg(0)), Get(inst->GetArg(1)), [](double a, double b) { return a * b; });
+        break;
+    case IR::Opcode::FPSub32:
+        Def(inst).value = FPOp32(ftz, dn, jit_state, static_cast<u32>(Get(inst->GetArg(0))), static_cast<u32>(Get(inst->GetArg(1))), [](float a, float b) { return a - b; });
+        break;
+    case IR::Opcode::FPSub64:
+        Def(inst).value = FPOp64(ftz, dn, jit_state, Get(inst->GetArg(0)), Get(inst->GetArg(1)), [](double a, double b) { return a - b; });
+        break;
+    case IR::Opcode::FPSqrt32:
+        Def(inst).value = FPOp32(ftz, dn, jit_state, static_cast<u32>(Get(inst->GetArg(0))), 0, [](float a, float) { return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(a))); });
+        break;
+    case IR::Opcode::FPSqrt64:
+        Def(inst).value = FPOp64(ftz, dn, jit_state, Get(inst->GetArg(0)), 0, [](double a, double) { return _mm_cvtsd_f64(_mm_sqrt_sd(_mm_setzero_pd(), _mm_set_sd(a))); });
+        break;
+    case IR::Opcode::FPCompare32: {
+        const __m128 a = _mm_set_ss(BitCast<float>(static_cast<u32>(Get(inst->GetArg(0)))));
+        const __m128 b = _mm_set_ss(BitCast<float>(static_cast<u32>(Get(inst->GetArg(1)))));
+        const bool quiet = inst->GetArg(2).GetU1();
+        // A signalling comparison raises Invalid Operation on a quiet NaN; a quiet comparison does not.
+        volatile int set_flags = quiet ? _mm_ucomieq_ss(a, b) : _mm_comieq_ss(a, b);
+        static_cast<void>(set_flags);
+        const float fa = _mm_cvtss_f32(a);
+        const float fb = _mm_cvtss_f32(b);
+        jit_state.FPSCR_nzcv = FPCompareToNZCV(std::isnan(fa) || std::isnan(fb), fa == fb, fa < fb);
+        break;
+    }
+    case IR::Opcode::FPCompare64: {
+        const __m128d a = _mm_set_sd(BitCast<double>(Get(inst->GetArg(0))));
+        const __m128d b = _mm_set_sd(BitCast<double>(Get(inst->GetArg(1))));
+        const bool quiet = inst->GetArg(2).GetU1();
+        volatile int set_flags = quiet ? _mm_ucomieq_sd(a, b) : _mm_comieq_sd(a, b);
+        static_cast<void>(set_flags);
+        const double da = _mm_cvtsd_f64(a);
+        const double db = _mm_cvtsd_f64(b);
+        jit_state.FPSCR_nzcv = FPCompareToNZCV(std::isnan(da) || std::isnan(db), da == db, da < db);
+        break;
+    }
+    case IR::Opcode::FPSingleToDouble: {
+        u32 a = static_cast<u32>(Get(inst->GetArg(0)));
+        if (ftz) {
+            DenormalsAreZero32(jit_state, a);
+        }
+        u64 result = BitCast<u64>(static_cast<double>(BitCast<float>(a)));
+        if (ftz) {
+            FlushToZero64(jit_state, result);
+        }
+        if (dn) {
+            DefaultNaN64(result);
+        }
+        Def(inst).value = result;
+        break;
+    }
+    case IR::Opcode::FPDoubleToSingle: {
+        u64 a = Get(inst->GetArg(0));
+        if (ftz) {
+            DenormalsAreZero64(jit_state, a);
+        }
+        u32 result = BitCast<u32>(static_cast<float>(BitCast<double>(a)));
+        if (ftz) {
+            FlushToZero32(jit_state, result);
+        }
+        if (dn) {
+            DefaultNaN32(result);
+        }
+        Def(inst).value = result;
+        break;
+    }
+    case IR::Opcode::FPSingleToS32:
+    case IR::Opcode::FPSingleToU32: {
+        u32 a = static_cast<u32>(Get(inst->GetArg(0)));
+        const bool round_towards_zero = inst->GetArg(1).GetU1();
+        if (ftz) {
+            DenormalsAreZero32(jit_state, a);
+        }
+        double from = static_cast<double>(BitCast<float>(a));
+        if (inst->GetOpcode() == IR::Opcode::FPSingleToS32) {
+            // The emitted code raises exceptions for NaNs before zeroing them.
+            volatile s32 set_flags = ConvertDoubleToS32(from, round_towards_zero);
+            static_cast<void>(set_flags);
+            Def(inst).value = SaturatingDoubleToS32(std::isnan(from) ? 0.0 : from, round_towards_zero);
+        } else {
+            Def(inst).value = SaturatingDoubleToU32(block, std::isnan(from) ? 0.0 : from, round_towards_zero);
+        }
+        break;
+    }
+    case IR::Opcode::FPDoubleToS32:
+    case IR::Opcode::FPDoubleToU32: {
+        u64 a = Get(inst->GetArg(0));
+        const bool round_towards_zero = inst->GetArg(1).GetU1();
+        if (ftz) {
+            DenormalsAreZero64(jit_state, a);
+        }
+        double from = BitCast<double>(a);
+        if (inst->GetOpcode() == IR::Opcode::FPDoubleToS32) {
+            volatile s32 set_flags = ConvertDoubleToS32(from, round_towards_zero);
+            static_cast<void>(set_flags);
+            Def(inst).value = SaturatingDoubleToS32(std::isnan(from) ? 0.0 : from, round_towards_zero);
+        } else {
+            Def(inst).value = SaturatingDoubleToU32(block, std::isnan(from) ? 0.0 : from, round_towards_zero);
+        }
+        break;
+    }
+    case IR::Opcode::FPS32ToSingle:
+        ASSERT_MSG(!inst->GetArg(1).GetU1(), "round_to_nearest unimplemented");
+        Def(inst).value = BitCast<u32>(static_cast<float>(static_cast<s32>(Get(inst->GetArg(0)))));
+        break;
+    case IR::Opcode::FPU32ToSingle:
+        ASSERT_MSG(!inst->GetArg(1).GetU1(), "round_to_nearest unimplemented");
+        Def(inst).value = BitCast<u32>(static_cast<float>(static_cast<s64>(static_cast<u32>(Get(inst->GetArg(0))))));
+        break;
+    case IR::Opcode::FPS32ToDouble:
+        ASSERT_MSG(!inst->GetArg(1).GetU1(), "round_to_nearest unimplemented");
+        Def(inst).value = BitCast<u64>(static_cast<double>(static_cast<s32>(Get(inst->GetArg(0)))));
+        break;
+    case IR::Opcode::FPU32ToDouble:
+        ASSERT_MSG(!inst->GetArg(1).GetU1(), "round_to_nearest unimplemented");
+        Def(inst).value = BitCast<u64>(static_cast<double>(static_cast<u32>(Get(inst->GetArg(0)))));
+        break;
+    default:
+        ASSERT_MSG(false, "Invalid opcode %zu", static_cast<size_t>(inst->GetOpcode()));
+        break;
+    }
+}
+
+void IRInterpreter::ExecuteTerminal(IR::Terminal terminal, IR::LocationDescriptor initial_location, JitState& jit_state) {
+    switch (terminal.which()) {
+    case 1: {
+        auto interpret = boost::get<IR::Term::Interpret>(terminal);
+        ASSERT_MSG(interpret.next.TFlag() == initial_location.TFlag(), "Unimplemented");
+        ASSERT_MSG(interpret.next.EFlag() == initial_location.EFlag(), "Unimplemented");
+        jit_state.Reg[15] = interpret.next.PC();
+        cb.InterpreterFallback(interpret.next.PC(), jit_interface, cb.user_arg);
+        return;
+    }
+    case 2: // ReturnToDispatch
+    case 8: // IndirectBranchHint: The interpreter has no inline caches to consult.
+        return;
+    case 5: { // PopRSBHint
+        const u64 unique_hash = IR::LocationDescriptor{jit_state.Reg[15], Arm::PSR{jit_state.Cpsr}, Arm::FPSCR{jit_state.FPSCR_mode}}.UniqueHash();
+        if (jit_state.rsb_location_descriptors[jit_state.rsb_ptr] == unique_hash) {
+            jit_state.rsb_hits++;
+        } else {
+            jit_state.rsb_misses++;
+        }
+        jit_state.rsb_ptr = (jit_state.rsb_ptr - 1) & static_cast<u32>(cb.rsb_size - 1);
+        return;
+    }
+    case 3:
+        ExecuteLinkBlock(boost::get<IR::Term::LinkBlock>(terminal).next, initial_location, jit_state);
+        return;
+    case 4:
+        ExecuteLinkBlock(boost::get<IR::Term::LinkBlockFast>(terminal).next, initial_location, jit_state);
+        return;
+    case 6: {
+        auto if_ = boost::get<IR::Term::If>(terminal);
+        ExecuteTerminal(ConditionPassed(if_.if_, jit_state.Cpsr) ? if_.then_ : if_.else_, initial_location, jit_state);
+        return;
+    }
+    case 7:
+        // The dispatcher checks for halts between blocks.
+        ExecuteTerminal(boost::get<IR::Term::CheckHalt>(terminal).else_, initial_location, jit_state);
+        return;
+    default:
+        ASSERT_MSG(false, "Invalid Terminal. Bad programmer.");
+        return;
+    }
+}
+
+void IRInterpreter::ExecuteLinkBlock(IR::LocationDescriptor next, IR::LocationDescriptor initial_location, JitState& jit_state) {
+    if (next.TFlag() != initial_location.TFlag()) {
+        jit_state.Cpsr = (jit_state.Cpsr & ~(1u << 5)) | (static_cast<u32>(next.TFlag()) << 5);
+    }
+    if (next.EFlag() != initial_location.EFlag()) {
+        jit_state.Cpsr = (jit_state.Cpsr & ~(1u << 9)) | (static_cast<u32>(next.EFlag()) << 9);
+    }
+    jit_state.Reg[15] = next.PC();
+}
+
+} // namespace BackendX64
+} // namespace Dynarmic
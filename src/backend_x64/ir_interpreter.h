@@ -0,0 +1,75 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2016 MerryMage
+ * This software may be used and distributed according to the terms of the GNU
+ * General Public License version 2 or any later version.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "backend_x64/jitstate.h"
+#include "common/common_types.h"
+#include "dynarmic/callbacks.h"
+#include "frontend/ir/basic_block.h"
+
+namespace Dynarmic {
+
+class Jit;
+
+namespace BackendX64 {
+
+class BlockOfCode;
+
+/**
+ * Executes the intermediate representation of a basic block directly over a JitState, without
+ * emitting any host code. Observable behaviour matches that of the code EmitX64 would emit for
+ * the same block, so the two tiers can be freely interleaved.
+ *
+ * This is used as a cold tier: a block is only worth the cost of emission once it has been
+ * executed a number of times (See: UserCallbacks::cold_block_threshold).
+ */
+class IRInterpreter final {
+public:
+    IRInterpreter(BlockOfCode* code, UserCallbacks cb, Jit* jit_interface);
+
+    /**
+     * Executes a single basic block, including its terminal.
+     * On return, R15 and the CPSR describe the location at which execution should continue.
+     * @note This assigns each instruction of block its index (See: IR::Inst::SetIndex).
+     * @returns The number of cycles executed.
+     */
+    size_t Execute(IR::Block& block, JitState& jit_state);
+
+private:
+    struct InstResult {
+        u64 value = 0;
+        bool carry = false;    ///< Result of an associated GetCarryFromOp
+        bool overflow = false; ///< Result of an associated GetOverflowFromOp
+        u32 ge = 0;            ///< Result of an associated GetGEFromOp
+        bool defined = false;
+    };
+
+    /// Executes a single microinstruction. Returns false if execution of the block must stop early.
+    bool ExecuteInst(const IR::Block& block, const IR::Inst* inst, JitState& jit_state);
+    /// Executes a single floating-point microinstruction under the guest's MXCSR.
+    void ExecuteFPInst(const IR::Block& block, const IR::Inst* inst, JitState& jit_state);
+
+    void ExecuteTerminal(IR::Terminal terminal, IR::LocationDescriptor initial_location, JitState& jit_state);
+    void ExecuteLinkBlock(IR::LocationDescriptor next, IR::LocationDescriptor initial_location, JitState& jit_state);
+
+    u64 Get(const IR::Value& arg) const;
+    const InstResult& Result(const IR::Inst* inst) const;
+    InstResult& Def(const IR::Inst* inst);
+
+    BlockOfCode* code;
+    UserCallbacks cb;
+    Jit* jit_interface;
+
+    // Per-block state
+    /// Indexed by IR::Inst::GetIndex(). The storage is reused between blocks.
+    std::vector<InstResult> results;
+};
+
+} // namespace BackendX64
+} // namespace Dynarmic
@@ -4,6 +4,8 @@
  * General Public License version 2 or any later version.
  */
 
+#include <algorithm>
+
 #include "backend_x64/block_of_code.h"
 #include "backend_x64/jitstate.h"
 #include "common/assert.h"
@@ -19,6 +21,81 @@ void JitState::ResetRSB() {
     rsb_codeptrs.fill(0);
 }
 
+/**
+ * Banked registers
+ * ================
+ *
+ * Mode         M[4:0]  Bank    Banked registers
+ * ----         ------  ----    ----------------
+ * User         0b10000 0       -
+ * FIQ          0b10001 1       R8-R14, SPSR
+ * IRQ          0b10010 2       R13-R14, SPSR
+ * Supervisor   0b10011 3       R13-R14, SPSR
+ * Abort        0b10111 4       R13-R14, SPSR
+ * Undefined    0b11011 5       R13-R14, SPSR
+ * System       0b11111 0       -
+ *
+ * User and System mode share a bank. R8-R12 are shared between all modes except FIQ mode.
+ * Reserved mode encodings are UNPREDICTABLE; we treat them as if they were User mode.
+ */
+
+static size_t BankIndexFromMode(u32 mode) {
+    switch (mode) {
+    case 0b10001:
+        return 1;
+    case 0b10010:
+        return 2;
+    case 0b10011:
+        return 3;
+    case 0b10111:
+        return 4;
+    case 0b11011:
+        return 5;
+    default:
+        return 0;
+    }
+}
+
+void JitState::SetCpsrWithModeSwitch(u32 new_cpsr) {
+    constexpr u32 mode_mask = 0x0000001F;
+    constexpr u32 user_mode = 0b10000;
+
+    if ((Cpsr & mode_mask) == user_mode) {
+        // Writes to the privileged bits of the CPSR are ignored in User mode.
+        constexpr u32 user_writable_mask = 0xF80F0200; // NZCVQ, GE, E
+        Cpsr = (Cpsr & ~user_writable_mask) | (new_cpsr & user_writable_mask);
+        return;
+    }
+
+    SetCpsrWithModeSwitchUnchecked(new_cpsr);
+}
+
+void JitState::SetCpsrWithModeSwitchUnchecked(u32 new_cpsr) {
+    constexpr u32 mode_mask = 0x0000001F;
+    constexpr size_t fiq_bank = 1;
+
+    const size_t old_bank = BankIndexFromMode(Cpsr & mode_mask);
+    const size_t new_bank = BankIndexFromMode(new_cpsr & mode_mask);
+
+    if (old_bank != new_bank) {
+        if ((old_bank == fiq_bank) != (new_bank == fiq_bank)) {
+            auto& old_r8_r12 = old_bank == fiq_bank ? Reg_fiq_R8_R12 : Reg_usr_R8_R12;
+            auto& new_r8_r12 = new_bank == fiq_bank ? Reg_fiq_R8_R12 : Reg_usr_R8_R12;
+            std::copy(Reg.begin() + 8, Reg.begin() + 13, old_r8_r12.begin());
+            std::copy(new_r8_r12.begin(), new_r8_r12.end(), Reg.begin() + 8);
+        }
+
+        Reg_banked_R13_R14[old_bank] = {Reg[13], Reg[14]};
+        Reg[13] = Reg_banked_R13_R14[new_bank][0];
+        Reg[14] = Reg_banked_R13_R14[new_bank][1];
+
+        Spsr_banked[old_bank] = Spsr;
+        Spsr = Spsr_banked[new_bank];
+    }
+
+    Cpsr = new_cpsr;
+}
+
 /**
  * Comparing MXCSR and FPSCR
  * =========================
@@ -78,6 +155,8 @@ void JitState::ResetRSB() {
 constexpr u32 FPSCR_MODE_MASK = IR::LocationDescriptor::FPSCR_MODE_MASK;
 constexpr u32 FPSCR_NZCV_MASK = 0xF0000000;
 
+// The following two functions have to match up with EmitX64::EmitGetFpscr and EmitX64::EmitSetFpscr.
+
 u32 JitState::Fpscr() const {
     ASSERT((FPSCR_mode & ~FPSCR_MODE_MASK) == 0);
     ASSERT((FPSCR_nzcv & ~FPSCR_NZCV_MASK) == 0);
@@ -93,7 +172,7 @@ u32 JitState::Fpscr() const {
     return FPSCR;
 }
 
-void JitState::SetFpscr(u32 FPSCR) {
+void JitState::SetFpscr(u32 FPSCR, bool mxcsr_ftz) {
     old_FPSCR = FPSCR;
     FPSCR_mode = FPSCR & FPSCR_MODE_MASK;
     FPSCR_nzcv = FPSCR & FPSCR_NZCV_MASK;
@@ -119,7 +198,9 @@ void JitState::SetFpscr(u32 FPSCR) {
 
     if (Common::Bit<24>(FPSCR)) {
         // VFP Flush to Zero
-        //guest_MXCSR |= (1 << 15); // SSE Flush to Zero
+        if (mxcsr_ftz) {
+            guest_MXCSR |= (1 << 15); // SSE Flush to Zero
+        }
         guest_MXCSR |= (1 << 6);  // SSE Denormals are Zero
     }
 }
@@ -15,8 +15,6 @@ namespace BackendX64 {
 
 class BlockOfCode;
 
-constexpr size_t SpillCount = 64;
-
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable:4324) // Structure was padded due to alignment specifier
@@ -25,30 +23,50 @@ constexpr size_t SpillCount = 64;
 struct JitState {
     JitState() { ResetRSB(); }
 
-    u32 Cpsr = 0;
-    std::array<u32, 16> Reg{}; // Current register file.
-    // TODO: Mode-specific register sets unimplemented.
-
-    alignas(u64) std::array<u32, 64> ExtReg{}; // Extension registers.
+    // The fields touched by every block come first, so that they share as few cache lines as possible.
 
-    std::array<u64, SpillCount> Spill{}; // Spill.
+    std::array<u32, 16> Reg{}; // Current register file.
+    u32 Cpsr = 0;
 
     // For internal use (See: BlockOfCode::RunCode)
     u32 guest_MXCSR = 0x00001f80;
     u32 save_host_MXCSR = 0;
-    s64 cycles_remaining = 0;
     bool halt_requested = false;
+    s64 cycles_remaining = 0;
+
+    // Return stack buffer (See: docs/ReturnStackBufferOptimization.md)
+    // Only the first UserCallbacks::rsb_size entries are used. rsb_ptr indexes the top of the stack.
+    static constexpr size_t RSBMaxSize = 64; // MUST be a power of 2.
+    u32 rsb_ptr = 0;
+    u64 rsb_hits = 0;   ///< Number of returns for which the top of the RSB was correctly predicted.
+    u64 rsb_misses = 0; ///< Number of returns for which it was not.
+    std::array<u64, RSBMaxSize> rsb_location_descriptors;
+    std::array<u64, RSBMaxSize> rsb_codeptrs;
+    void ResetRSB();
+
+    u32 Spsr = 0; // SPSR of the current mode.
+
+    // Mode-specific register sets (See: JitState::SetCpsrWithModeSwitch).
+    // Reg and Spsr always hold the values for the current mode; only the banked copies belonging
+    // to modes other than the current mode are meaningful.
+    std::array<u32, 5> Reg_usr_R8_R12{};
+    std::array<u32, 5> Reg_fiq_R8_R12{};
+    std::array<std::array<u32, 2>, 6> Reg_banked_R13_R14{};
+    std::array<u32, 6> Spsr_banked{};
+    /// Writes CPSR as the guest would. In User mode only the unprivileged bits are written.
+    void SetCpsrWithModeSwitch(u32 new_cpsr);
+    /// Writes CPSR regardless of the current mode. Used by the host.
+    void SetCpsrWithModeSwitchUnchecked(u32 new_cpsr);
+
+    alignas(u64) std::array<u32, 64> ExtReg{}; // Extension registers.
 
     // Exclusive state
     static constexpr u32 RESERVATION_GRANULE_MASK = 0xFFFFFFF8;
     u32 exclusive_state = 0;
     u32 exclusive_address = 0;
 
-    static constexpr size_t RSBSize = 8; // MUST be a power of 2.
-    u32 rsb_ptr = 0;
-    std::array<u64, RSBSize> rsb_location_descriptors;
-    std::array<u64, RSBSize> rsb_codeptrs;
-    void ResetRSB();
+    // Inline caches for indirect branches (See: IR::Term::IndirectBranchHint)
+    u64 indirect_branch_cache_miss = 0; ///< Address of the inline cache that most recently missed, or 0.
 
     u32 FPSCR_IDC = 0;
     u32 FPSCR_UFC = 0;
@@ -56,7 +74,8 @@ struct JitState {
     u32 FPSCR_nzcv = 0;
     u32 old_FPSCR = 0;
     u32 Fpscr() const;
-    void SetFpscr(u32 FPSCR);
+    /// If mxcsr_ftz is set, FPSCR.FZ also enables SSE Flush to Zero (See: UserCallbacks::fast_fp).
+    void SetFpscr(u32 FPSCR, bool mxcsr_ftz);
 };
 
 #ifdef _MSC_VER
@@ -0,0 +1,56 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2016 MerryMage
+ * This software may be used and distributed according to the terms of the GNU
+ * General Public License version 2 or any later version.
+ */
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+
+#include "backend_x64/perf_map.h"
+#include "common/common_types.h"
+
+namespace Dynarmic {
+namespace BackendX64 {
+
+#ifdef __linux__
+
+namespace {
+std::mutex perf_map_mutex;
+std::FILE* perf_map_file = nullptr;
+} // anonymous namespace
+
+void PerfMapRegister(const void* start, std::size_t size, const std::string& name) {
+    if (size == 0)
+        return;
+
+    std::lock_guard<std::mutex> guard{perf_map_mutex};
+
+    if (!perf_map_file) {
+        const std::string filename = fmt::format("/tmp/perf-{}.map", getpid());
+        perf_map_file = std::fopen(filename.c_str(), "w");
+        if (!perf_map_file)
+            return;
+    }
+
+    // Format: <start address> <size> <symbol name>, with numbers in hexadecimal.
+    const std::string line = fmt::format("{:x} {:x} {}\n", reinterpret_cast<u64>(start), size, name);
+    std::fputs(line.c_str(), perf_map_file);
+    std::fflush(perf_map_file);
+}
+
+#else
+
+void PerfMapRegister(const void*, std::size_t, const std::string&) {}
+
+#endif
+
+} // namespace BackendX64
+} // namespace Dynarmic
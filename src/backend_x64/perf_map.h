@@ -0,0 +1,24 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2016 MerryMage
+ * This software may be used and distributed according to the terms of the GNU
+ * General Public License version 2 or any later version.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Dynarmic {
+namespace BackendX64 {
+
+/**
+ * Names a region of emitted code for Linux perf by appending an entry to /tmp/perf-<pid>.map
+ * (See: UserCallbacks::enable_perf_map). The file is shared by all Jit instances in the process.
+ * perf has no way to retire entries, so after a cache clear a later entry for reused code supersedes
+ * the earlier one. This does nothing on other platforms.
+ */
+void PerfMapRegister(const void* start, std::size_t size, const std::string& name);
+
+} // namespace BackendX64
+} // namespace Dynarmic
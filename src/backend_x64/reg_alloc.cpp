@@ -5,6 +5,7 @@
  */
 
 #include <algorithm>
+#include <bitset>
 
 #include <xbyak.h>
 
@@ -42,20 +43,27 @@ static Xbyak::Reg HostLocToX64(HostLoc hostloc) {
     ASSERT_MSG(false, "This should never happen.");
 }
 
+RegAlloc::RegAlloc(BlockOfCode* code, HostLocList reserved_locations) : code(code) {
+    for (HostLoc loc : reserved_locations) {
+        DEBUG_ASSERT(HostLocIsGPR(loc));
+        reserved[static_cast<size_t>(loc)] = true;
+    }
+}
+
 HostLoc RegAlloc::DefHostLocReg(IR::Inst* def_inst, HostLocList desired_locations) {
     DEBUG_ASSERT(std::all_of(desired_locations.begin(), desired_locations.end(), HostLocIsRegister));
     DEBUG_ASSERT_MSG(!ValueLocation(def_inst), "def_inst has already been defined");
 
-    HostLoc location = SelectARegister(desired_locations);
+    HostLoc location = SelectARegister(desired_locations, def_inst);
 
     if (IsRegisterOccupied(location)) {
         SpillRegister(location);
     }
 
-    LocInfo(location).is_being_used = true;
-    LocInfo(location).def = def_inst;
+    MarkAllocated(location);
+    SetDef(location, def_inst);
 
-    DEBUG_ASSERT(LocInfo(location).IsDef());
+    DEBUG_ASSERT(IsDef(location));
     return location;
 }
 
@@ -69,9 +77,9 @@ void RegAlloc::RegisterAddDef(IR::Inst* def_inst, const IR::Value& use_inst) {
 
     DEBUG_ASSERT_MSG(ValueLocation(use_inst.GetInst()), "use_inst must already be defined");
     HostLoc location = *ValueLocation(use_inst.GetInst());
-    LocInfo(location).values.emplace_back(def_inst);
+    AddValue(location, def_inst);
     use_inst.GetInst()->DecrementRemainingUses();
-    DEBUG_ASSERT(LocInfo(location).IsIdle());
+    DEBUG_ASSERT(IsIdle(location));
 }
 
 HostLoc RegAlloc::UseDefHostLocReg(IR::Value use_value, IR::Inst* def_inst, HostLocList desired_locations) {
@@ -89,19 +97,17 @@ HostLoc RegAlloc::UseDefHostLocReg(IR::Inst* use_inst, IR::Inst* def_inst, HostL
 
     if (IsLastUse(use_inst)) {
         HostLoc current_location = *ValueLocation(use_inst);
-        auto& loc_info = LocInfo(current_location);
-        if (loc_info.IsIdle()) {
-            loc_info.is_being_used = true;
-            loc_info.def = def_inst;
-            DEBUG_ASSERT(loc_info.IsUseDef());
+        if (IsIdle(current_location)) {
+            MarkAllocated(current_location);
+            SetDef(current_location, def_inst);
+            DEBUG_ASSERT(IsUseDef(current_location));
             if (HostLocIsSpill(current_location)) {
-                HostLoc new_location = SelectARegister(desired_locations);
+                HostLoc new_location = SelectARegister(desired_locations, def_inst);
                 if (IsRegisterOccupied(new_location)) {
                     SpillRegister(new_location);
                 }
                 EmitMove(new_location, current_location);
-                LocInfo(new_location) = LocInfo(current_location);
-                LocInfo(current_location) = {};
+                MoveHostLoc(new_location, current_location);
                 return new_location;
             } else {
                 return current_location;
@@ -133,16 +139,15 @@ std::tuple<OpArg, HostLoc> RegAlloc::UseDefOpArgHostLocReg(IR::Value use_value,
 
         if (IsLastUse(use_inst)) {
             HostLoc current_location = *ValueLocation(use_inst);
-            auto& loc_info = LocInfo(current_location);
-            if (!loc_info.IsIdle()) {
+            if (!IsIdle(current_location)) {
                 if (HostLocIsSpill(current_location)) {
-                    loc_info.is_being_used = true;
-                    DEBUG_ASSERT(loc_info.IsUse());
+                    MarkAllocated(current_location);
+                    DEBUG_ASSERT(IsUse(current_location));
                     return std::make_tuple(SpillToOpArg(current_location), DefHostLocReg(def_inst, desired_locations));
                 } else {
-                    loc_info.is_being_used = true;
-                    loc_info.def = def_inst;
-                    DEBUG_ASSERT(loc_info.IsUseDef());
+                    MarkAllocated(current_location);
+                    SetDef(current_location, def_inst);
+                    DEBUG_ASSERT(IsUseDef(current_location));
                     return std::make_tuple(HostLocToX64(current_location), current_location);
                 }
             }
@@ -170,18 +175,17 @@ HostLoc RegAlloc::UseHostLocReg(IR::Inst* use_inst, HostLocList desired_location
     if (HostLocIsRegister(current_location)) {
         return current_location;
     } else if (HostLocIsSpill(current_location)) {
-        HostLoc new_location = SelectARegister(desired_locations);
+        HostLoc new_location = SelectARegister(desired_locations, use_inst);
         if (IsRegisterOccupied(new_location)) {
             SpillRegister(new_location);
         }
         EmitMove(new_location, current_location);
         if (!was_being_used) {
-            LocInfo(new_location) = LocInfo(current_location);
-            LocInfo(current_location) = {};
-            DEBUG_ASSERT(LocInfo(new_location).IsUse());
+            MoveHostLoc(new_location, current_location);
+            DEBUG_ASSERT(IsUse(new_location));
         } else {
-            LocInfo(new_location).is_being_used = true;
-            DEBUG_ASSERT(LocInfo(new_location).IsScratch());
+            MarkAllocated(new_location);
+            DEBUG_ASSERT(IsScratch(new_location));
         }
         return new_location;
     }
@@ -231,25 +235,25 @@ HostLoc RegAlloc::UseScratchHostLocReg(IR::Inst* use_inst, HostLocList desired_l
 
     if (HostLocIsSpill(current_location)) {
         EmitMove(new_location, current_location);
-        LocInfo(new_location).is_being_used = true;
+        MarkAllocated(new_location);
         use_inst->DecrementRemainingUses();
-        DEBUG_ASSERT(LocInfo(new_location).IsScratch());
+        DEBUG_ASSERT(IsScratch(new_location));
         return new_location;
     } else if (HostLocIsRegister(current_location)) {
-        ASSERT(LocInfo(current_location).IsIdle()
-                || LocInfo(current_location).IsUse()
-                || LocInfo(current_location).IsUseDef());
+        ASSERT(IsIdle(current_location)
+                || IsUse(current_location)
+                || IsUseDef(current_location));
 
         if (current_location != new_location) {
             EmitMove(new_location, current_location);
         } else {
-            ASSERT(LocInfo(current_location).IsIdle());
+            ASSERT(IsIdle(current_location));
         }
 
-        LocInfo(new_location).is_being_used = true;
-        LocInfo(new_location).values.clear();
+        MarkAllocated(new_location);
+        ClearValues(new_location);
         use_inst->DecrementRemainingUses();
-        DEBUG_ASSERT(LocInfo(new_location).IsScratch());
+        DEBUG_ASSERT(IsScratch(new_location));
         return new_location;
     }
 
@@ -266,9 +270,9 @@ HostLoc RegAlloc::ScratchHostLocReg(HostLocList desired_locations) {
     }
 
     // Update state
-    LocInfo(location).is_being_used = true;
+    MarkAllocated(location);
 
-    DEBUG_ASSERT(LocInfo(location).IsScratch());
+    DEBUG_ASSERT(IsScratch(location));
     return location;
 }
 
@@ -307,49 +311,98 @@ void RegAlloc::HostCall(IR::Inst* result_def, IR::Value arg0_use, IR::Value arg1
     }
 }
 
-HostLoc RegAlloc::SelectARegister(HostLocList desired_locations) const {
-    std::vector<HostLoc> candidates = desired_locations;
+static bool HostLocIsCalleeSave(HostLoc loc) {
+    static const std::bitset<HostLocCount> callee_save = []{
+        std::bitset<HostLocCount> ret;
+        for (HostLoc hostloc : ABI_ALL_CALLEE_SAVE)
+            ret[static_cast<size_t>(hostloc)] = true;
+        return ret;
+    }();
+    return callee_save[static_cast<size_t>(loc)];
+}
+
+/**
+ * Selects the best location out of the available locations for holding `value` (or a scratch if null).
+ * Reserved locations are never selected:
+ * 1. An unoccupied callee-save register if `value` lives across a HostCall, or an unoccupied caller-save register otherwise.
+ * 2. Any unoccupied register.
+ * 3. The occupied register whose contents are next used furthest in the future, as it is the cheapest to spill.
+ */
+HostLoc RegAlloc::SelectARegister(HostLocList desired_locations, const IR::Inst* value) {
+    const bool want_callee_save = value && IsLiveAcrossHostCall(value);
+
+    boost::optional<HostLoc> unoccupied_candidate;
+    boost::optional<HostLoc> occupied_candidate;
+    u32 occupied_candidate_next_use = 0;
+    for (HostLoc loc : desired_locations) {
+        if (reserved[static_cast<size_t>(loc)] || IsRegisterAllocated(loc))
+            continue;
+
+        if (!IsRegisterOccupied(loc)) {
+            if (HostLocIsCalleeSave(loc) == want_callee_save)
+                return loc;
+            if (!unoccupied_candidate)
+                unoccupied_candidate = loc;
+            continue;
+        }
 
-    // Find all locations that have not been allocated..
-    auto allocated_locs = std::partition(candidates.begin(), candidates.end(), [this](auto loc){
-        return !this->IsRegisterAllocated(loc);
-    });
-    candidates.erase(allocated_locs, candidates.end());
-    ASSERT_MSG(!candidates.empty(), "All candidate registers have already been allocated");
+        if (unoccupied_candidate)
+            continue;
+        const u32 next_use = NextUseOfLocation(loc);
+        if (!occupied_candidate || next_use > occupied_candidate_next_use) {
+            occupied_candidate = loc;
+            occupied_candidate_next_use = next_use;
+        }
+    }
 
-    // Selects the best location out of the available locations.
-    // TODO: Actually do LRU or something. Currently we just try to pick something without a value if possible.
+    if (unoccupied_candidate)
+        return *unoccupied_candidate;
+    ASSERT_MSG(occupied_candidate, "All candidate registers have already been allocated");
+    return *occupied_candidate;
+}
 
-    std::partition(candidates.begin(), candidates.end(), [this](auto loc){
-        return !this->IsRegisterOccupied(loc);
-    });
+/// Returns the index of the next instruction at or after the current one that uses `value`, or no_value if there is none.
+u32 RegAlloc::NextUse(const IR::Inst* value) {
+    u32& slot = value_info[value->GetIndex()].next_use;
+    while (slot != no_value && slot / max_arg_count < current_index)
+        slot = use_chain[slot];
+    return slot == no_value ? no_value : slot / max_arg_count;
+}
 
-    return candidates.front();
+u32 RegAlloc::NextUseOfLocation(HostLoc loc) {
+    u32 next_use = no_value;
+    for (u32 i = LocInfo(loc).first_value; i != no_value; i = value_info[i].next)
+        next_use = std::min(next_use, NextUse(value_info[i].inst));
+    return next_use;
+}
+
+bool RegAlloc::IsLiveAcrossHostCall(const IR::Inst* value) const {
+    if (current_index >= next_host_call.size())
+        return false;
+    return value_info[value->GetIndex()].last_use > next_host_call[current_index];
 }
 
 boost::optional<HostLoc> RegAlloc::ValueLocation(const IR::Inst* value) const {
-    for (size_t i = 0; i < HostLocCount; i++)
-        for (const IR::Inst* v : hostloc_info[i].values)
-            if (v == value)
-                return boost::make_optional<HostLoc>(static_cast<HostLoc>(i));
+    DEBUG_ASSERT(value->GetIndex() < value_info.size());
+    const ValueInfo& info = value_info[value->GetIndex()];
+    if (info.has_location && info.inst == value)
+        return info.location;
 
     return boost::none;
 }
 
 bool RegAlloc::IsRegisterOccupied(HostLoc loc) const {
-    const auto& info = LocInfo(loc);
-
-    return !info.values.empty() || info.def;
+    return occupied[LocIndex(loc)];
 }
 
 bool RegAlloc::IsRegisterAllocated(HostLoc loc) const {
-    return LocInfo(loc).is_being_used;
+    return allocated[LocIndex(loc)];
 }
 
 bool RegAlloc::IsLastUse(const IR::Inst* inst) const {
     if (inst->UseCount() > 1)
         return false;
-    return LocInfo(*ValueLocation(inst)).values.size() == 1;
+    return LocInfo(*ValueLocation(inst)).value_count == 1;
 }
 
 void RegAlloc::SpillRegister(HostLoc loc) {
@@ -361,8 +414,7 @@ void RegAlloc::SpillRegister(HostLoc loc) {
 
     EmitMove(new_loc, loc);
 
-    LocInfo(new_loc) = LocInfo(loc);
-    LocInfo(loc) = {};
+    MoveHostLoc(new_loc, loc);
 }
 
 HostLoc RegAlloc::FindFreeSpill() const {
@@ -374,27 +426,152 @@ HostLoc RegAlloc::FindFreeSpill() const {
 }
 
 void RegAlloc::EndOfAllocScope() {
-    for (auto& iter : hostloc_info) {
-        iter.is_being_used = false;
-        if (iter.def) {
-            iter.values.clear();
-            iter.values.emplace_back(iter.def);
-            iter.def = nullptr;
-        }
-        if (!iter.values.empty()) {
-            auto to_erase = std::remove_if(iter.values.begin(), iter.values.end(),
-                                           [](const auto& inst){ return !inst->HasUses(); });
-            iter.values.erase(to_erase, iter.values.end());
+    allocated.reset();
+
+    for (size_t i = 0; i < HostLocCount; i++) {
+        if (!occupied[i])
+            continue;
+
+        const HostLoc loc = static_cast<HostLoc>(i);
+        if (IR::Inst* def = LocInfo(loc).def) {
+            ClearValues(loc);
+            LocInfo(loc).def = nullptr;
+            AddValue(loc, def);
         }
+        RemoveValuesWithoutUses(loc);
     }
 }
 
 void RegAlloc::AssertNoMoreUses() {
-    ASSERT(std::all_of(hostloc_info.begin(), hostloc_info.end(), [](const auto& i){ return i.values.empty(); }));
+    ASSERT(std::all_of(hostloc_info.begin(), hostloc_info.end(), [](const auto& i){ return i.value_count == 0; }));
 }
 
-void RegAlloc::Reset() {
+void RegAlloc::Reset(IR::Block& block, std::function<bool(const IR::Inst&)> calls_host) {
     hostloc_info.fill({});
+    allocated.reset();
+    occupied.reset();
+    current_index = 0;
+
+    u32 index = 0;
+    for (IR::Inst& inst : block) {
+        inst.SetIndex(index++);
+    }
+    value_info.assign(index, {});
+    use_chain.assign(index * max_arg_count, no_value);
+    next_host_call.assign(index, no_value);
+
+    // A single backwards pass threads the uses of each value into a list ordered by position,
+    // and records each value's last use and the next HostCall after each instruction.
+    u32 next_call = no_value;
+    for (auto iter = block.rbegin(); iter != block.rend(); ++iter) {
+        const IR::Inst& inst = *iter;
+        const u32 inst_index = inst.GetIndex();
+
+        next_host_call[inst_index] = next_call;
+        if (calls_host(inst))
+            next_call = inst_index;
+
+        DEBUG_ASSERT(inst.NumArgs() <= max_arg_count);
+        for (size_t i = 0; i < inst.NumArgs(); i++) {
+            const IR::Value arg = inst.GetArg(i);
+            if (arg.IsImmediate())
+                continue;
+
+            ValueInfo& used = value_info[arg.GetInst()->GetIndex()];
+            const u32 slot = inst_index * max_arg_count + static_cast<u32>(i);
+            use_chain[slot] = used.next_use;
+            used.next_use = slot;
+            used.last_use = std::max(used.last_use, inst_index);
+        }
+    }
+}
+
+void RegAlloc::StartOfAllocScope(const IR::Inst* inst) {
+    current_index = inst->GetIndex();
+}
+
+void RegAlloc::MarkAllocated(HostLoc loc) {
+    allocated[LocIndex(loc)] = true;
+}
+
+void RegAlloc::SetDef(HostLoc loc, IR::Inst* def_inst) {
+    LocInfo(loc).def = def_inst;
+    occupied[LocIndex(loc)] = true;
+}
+
+void RegAlloc::AddValue(HostLoc loc, IR::Inst* value) {
+    DEBUG_ASSERT(value->GetIndex() < value_info.size());
+    const u32 index = value->GetIndex();
+    HostLocInfo& info = LocInfo(loc);
+
+    value_info[index].inst = value;
+    value_info[index].has_location = true;
+    value_info[index].location = loc;
+    value_info[index].next = info.first_value;
+    info.first_value = index;
+    info.value_count++;
+    occupied[LocIndex(loc)] = true;
+}
+
+void RegAlloc::ClearValues(HostLoc loc) {
+    HostLocInfo& info = LocInfo(loc);
+
+    for (u32 i = info.first_value; i != no_value; i = value_info[i].next) {
+        value_info[i].has_location = false;
+    }
+    info.first_value = no_value;
+    info.value_count = 0;
+    occupied[LocIndex(loc)] = info.def != nullptr;
+}
+
+void RegAlloc::RemoveValuesWithoutUses(HostLoc loc) {
+    HostLocInfo& info = LocInfo(loc);
+
+    u32* link = &info.first_value;
+    while (*link != no_value) {
+        ValueInfo& value = value_info[*link];
+        if (value.inst->HasUses()) {
+            link = &value.next;
+        } else {
+            value.has_location = false;
+            *link = value.next;
+            info.value_count--;
+        }
+    }
+    occupied[LocIndex(loc)] = info.value_count != 0 || info.def != nullptr;
+}
+
+void RegAlloc::MoveHostLoc(HostLoc to, HostLoc from) {
+    DEBUG_ASSERT(!IsRegisterOccupied(to));
+
+    LocInfo(to) = LocInfo(from);
+    LocInfo(from) = {};
+    allocated[LocIndex(to)] = allocated[LocIndex(from)];
+    allocated[LocIndex(from)] = false;
+    occupied[LocIndex(to)] = occupied[LocIndex(from)];
+    occupied[LocIndex(from)] = false;
+
+    UpdateValueLocations(to);
+}
+
+void RegAlloc::ExchangeHostLocs(HostLoc a, HostLoc b) {
+    std::swap(LocInfo(a), LocInfo(b));
+
+    const bool a_allocated = allocated[LocIndex(a)];
+    allocated[LocIndex(a)] = allocated[LocIndex(b)];
+    allocated[LocIndex(b)] = a_allocated;
+    const bool a_occupied = occupied[LocIndex(a)];
+    occupied[LocIndex(a)] = occupied[LocIndex(b)];
+    occupied[LocIndex(b)] = a_occupied;
+
+    UpdateValueLocations(a);
+    UpdateValueLocations(b);
+}
+
+void RegAlloc::UpdateValueLocations(HostLoc loc) {
+    for (u32 i = LocInfo(loc).first_value; i != no_value; i = value_info[i].next) {
+        value_info[i].location = loc;
+    }
 }
 
 void RegAlloc::EmitMove(HostLoc to, HostLoc from) {
@@ -432,41 +609,41 @@ std::tuple<HostLoc, bool> RegAlloc::UseHostLoc(IR::Inst* use_inst, HostLocList d
     HostLoc current_location = *ValueLocation(use_inst);
     auto iter = std::find(desired_locations.begin(), desired_locations.end(), current_location);
     if (iter != desired_locations.end()) {
-        if (LocInfo(current_location).IsDef()) {
-            HostLoc new_location = SelectARegister(desired_locations);
+        if (IsDef(current_location)) {
+            HostLoc new_location = SelectARegister(desired_locations, use_inst);
             if (IsRegisterOccupied(new_location)) {
                 SpillRegister(new_location);
             }
             EmitMove(new_location, current_location);
-            LocInfo(new_location).is_being_used = true;
-            LocInfo(new_location).values.emplace_back(use_inst);
+            MarkAllocated(new_location);
+            AddValue(new_location, use_inst);
             use_inst->DecrementRemainingUses();
-            DEBUG_ASSERT(LocInfo(new_location).IsUse());
+            DEBUG_ASSERT(IsUse(new_location));
             return std::make_tuple(new_location, false);
         } else {
-            bool was_being_used = LocInfo(current_location).is_being_used;
-            ASSERT(LocInfo(current_location).IsUse() || LocInfo(current_location).IsIdle());
-            LocInfo(current_location).is_being_used = true;
+            bool was_being_used = IsRegisterAllocated(current_location);
+            ASSERT(IsUse(current_location) || IsIdle(current_location));
+            MarkAllocated(current_location);
             use_inst->DecrementRemainingUses();
-            DEBUG_ASSERT(LocInfo(current_location).IsUse());
+            DEBUG_ASSERT(IsUse(current_location));
             return std::make_tuple(current_location, was_being_used);
         }
     }
 
     if (HostLocIsSpill(current_location)) {
-        bool was_being_used = LocInfo(current_location).is_being_used;
-        LocInfo(current_location).is_being_used = true;
+        bool was_being_used = IsRegisterAllocated(current_location);
+        MarkAllocated(current_location);
         use_inst->DecrementRemainingUses();
-        DEBUG_ASSERT(LocInfo(current_location).IsUse());
+        DEBUG_ASSERT(IsUse(current_location));
         return std::make_tuple(current_location, was_being_used);
     } else if (HostLocIsRegister(current_location)) {
-        HostLoc new_location = SelectARegister(desired_locations);
-        ASSERT(LocInfo(current_location).IsIdle());
+        HostLoc new_location = SelectARegister(desired_locations, use_inst);
+        ASSERT(IsIdle(current_location));
         EmitExchange(new_location, current_location);
-        std::swap(LocInfo(new_location), LocInfo(current_location));
-        LocInfo(new_location).is_being_used = true;
+        ExchangeHostLocs(new_location, current_location);
+        MarkAllocated(new_location);
         use_inst->DecrementRemainingUses();
-        DEBUG_ASSERT(LocInfo(new_location).IsUse());
+        DEBUG_ASSERT(IsUse(new_location));
         return std::make_tuple(new_location, false);
     }
 
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <array>
+#include <bitset>
+#include <functional>
 #include <vector>
 
 #include <boost/optional.hpp>
@@ -15,6 +17,7 @@
 #include "backend_x64/block_of_code.h"
 #include "backend_x64/hostloc.h"
 #include "common/common_types.h"
+#include "frontend/ir/basic_block.h"
 #include "frontend/ir/microinstruction.h"
 #include "frontend/ir/value.h"
 
@@ -86,7 +89,11 @@ private:
 
 class RegAlloc final {
 public:
-    explicit RegAlloc(BlockOfCode* code) : code(code) {}
+    /**
+     * @param reserved_locations Registers which hold a value for the lifetime of the JIT, and so are never
+     *                           allocated even if they appear in desired_locations.
+     */
+    RegAlloc(BlockOfCode* code, HostLocList reserved_locations);
 
     /// Late-def
     Xbyak::Reg64 DefGpr(IR::Inst* def_inst, HostLocList desired_locations = any_gpr) {
@@ -147,10 +154,21 @@ public:
 
     void AssertNoMoreUses();
 
-    void Reset();
+    /**
+     * Prepares the allocator for emitting `block`. This assigns each instruction its index (See: IR::Inst::SetIndex)
+     * and computes the next-use information used to select registers and spill victims.
+     * @param calls_host Determines whether emitting an instruction will perform a HostCall.
+     */
+    void Reset(IR::Block& block, std::function<bool(const IR::Inst&)> calls_host);
+
+    /// Informs the allocator that allocations are about to be made for `inst`.
+    void StartOfAllocScope(const IR::Inst* inst);
 
 private:
-    HostLoc SelectARegister(HostLocList desired_locations) const;
+    HostLoc SelectARegister(HostLocList desired_locations, const IR::Inst* value = nullptr);
+    u32 NextUse(const IR::Inst* value);
+    u32 NextUseOfLocation(HostLoc loc);
+    bool IsLiveAcrossHostCall(const IR::Inst* value) const;
     boost::optional<HostLoc> ValueLocation(const IR::Inst* value) const;
     bool IsRegisterOccupied(HostLoc loc) const;
     bool IsRegisterAllocated(HostLoc loc) const;
@@ -176,36 +194,72 @@ private:
 
     BlockOfCode* code = nullptr;
 
-    struct HostLocInfo {
-        std::vector<IR::Inst*> values; // early value
-        IR::Inst* def = nullptr; // late value
-        bool is_being_used = false;
+    static constexpr u32 no_value = 0xFFFFFFFF;
+    static constexpr u32 max_arg_count = 3;
 
-        bool IsIdle() const {
-            return !is_being_used;
-        }
-        bool IsScratch() const {
-            return is_being_used && !def && values.empty();
-        }
-        bool IsUse() const {
-            return is_being_used && !def && !values.empty();
-        }
-        bool IsDef() const {
-            return is_being_used && def && values.empty();
-        }
-        bool IsUseDef() const {
-            return is_being_used && def && !values.empty();
-        }
+    /// Per-instruction state, indexed by IR::Inst::GetIndex().
+    struct ValueInfo {
+        IR::Inst* inst = nullptr;
+        bool has_location = false;
+        HostLoc location = HostLoc::RAX;
+        u32 next = no_value; ///< Next value held in the same location
+        u32 next_use = no_value; ///< Use slot (See: use_chain) of the next use at or after current_index
+        u32 last_use = 0; ///< Index of the instruction which last uses this value
+    };
+    /// Capacity is retained between blocks, so no allocation happens per instruction.
+    std::vector<ValueInfo> value_info;
+    /// Indexed by use slot (instruction index * max_arg_count + argument number): the slot of the following use of the same value.
+    std::vector<u32> use_chain;
+    /// Indexed by instruction index: the index of the next instruction after it that performs a HostCall.
+    std::vector<u32> next_host_call;
+    u32 current_index = 0;
+
+    struct HostLocInfo {
+        u32 first_value = no_value; ///< early values, as a list threaded through value_info
+        u32 value_count = 0;
+        IR::Inst* def = nullptr; ///< late value
     };
     std::array<HostLocInfo, HostLocCount> hostloc_info;
+    std::bitset<HostLocCount> allocated; ///< Locations in use by the current instruction
+    std::bitset<HostLocCount> occupied;  ///< Locations holding at least one value or a def
+    std::bitset<HostLocCount> reserved;  ///< Locations which are never allocated
+
+    size_t LocIndex(HostLoc loc) const {
+        DEBUG_ASSERT(loc != HostLoc::RSP && loc != HostLoc::R15 && !reserved[static_cast<size_t>(loc)]);
+        return static_cast<size_t>(loc);
+    }
     HostLocInfo& LocInfo(HostLoc loc) {
-        DEBUG_ASSERT(loc != HostLoc::RSP && loc != HostLoc::R15);
-        return hostloc_info[static_cast<size_t>(loc)];
+        return hostloc_info[LocIndex(loc)];
     }
     const HostLocInfo& LocInfo(HostLoc loc) const {
-        DEBUG_ASSERT(loc != HostLoc::RSP && loc != HostLoc::R15);
-        return hostloc_info[static_cast<size_t>(loc)];
+        return hostloc_info[LocIndex(loc)];
+    }
+
+    bool IsIdle(HostLoc loc) const {
+        return !allocated[LocIndex(loc)];
+    }
+    bool IsScratch(HostLoc loc) const {
+        return allocated[LocIndex(loc)] && !LocInfo(loc).def && LocInfo(loc).value_count == 0;
     }
+    bool IsUse(HostLoc loc) const {
+        return allocated[LocIndex(loc)] && !LocInfo(loc).def && LocInfo(loc).value_count != 0;
+    }
+    bool IsDef(HostLoc loc) const {
+        return allocated[LocIndex(loc)] && LocInfo(loc).def && LocInfo(loc).value_count == 0;
+    }
+    bool IsUseDef(HostLoc loc) const {
+        return allocated[LocIndex(loc)] && LocInfo(loc).def && LocInfo(loc).value_count != 0;
+    }
+
+    // All changes to the above state go through these, which keep hostloc_info, value_info and the bitsets consistent.
+    void MarkAllocated(HostLoc loc);
+    void SetDef(HostLoc loc, IR::Inst* def_inst);
+    void AddValue(HostLoc loc, IR::Inst* value);
+    void ClearValues(HostLoc loc);
+    void RemoveValuesWithoutUses(HostLoc loc);
+    void MoveHostLoc(HostLoc to, HostLoc from);
+    void ExchangeHostLocs(HostLoc a, HostLoc b);
+    void UpdateValueLocations(HostLoc loc);
 };
 
 } // namespace BackendX64
@@ -4,19 +4,298 @@
  * General Public License version 2 or any later version.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "backend_x64/abi.h"
 #include "backend_x64/block_of_code.h"
+#include "backend_x64/hostloc.h"
+#include "common/assert.h"
+#include "common/common_types.h"
+
+// Provided by the unwinder (libgcc or libunwind).
+extern "C" void __register_frame(void*);
+extern "C" void __deregister_frame(void*);
 
 namespace Dynarmic {
 namespace BackendX64 {
 
+// DWARF call frame instructions (See: DWARF 4 specification, section 6.4.2)
+enum : u8 {
+    DW_CFA_nop = 0x00,
+    DW_CFA_advance_loc1 = 0x02,
+    DW_CFA_advance_loc2 = 0x03,
+    DW_CFA_advance_loc4 = 0x04,
+    DW_CFA_remember_state = 0x0a,
+    DW_CFA_restore_state = 0x0b,
+    DW_CFA_def_cfa = 0x0c,
+    DW_CFA_def_cfa_offset = 0x0e,
+    DW_CFA_advance_loc = 0x40,
+    DW_CFA_offset = 0x80,
+};
+
+constexpr u8 DW_EH_PE_absptr = 0x00;
+constexpr u8 DWARF_REG_RSP = 7;
+constexpr u8 DWARF_REG_RA = 16;
+
+static u8 HostLocToDwarfRegister(HostLoc loc) {
+    // The DWARF numbering of the x86-64 GPRs differs from their encoding.
+    static const u8 dwarf_registers[] = {0, 2, 1, 3, 7, 6, 4, 5, 8, 9, 10, 11, 12, 13, 14, 15};
+    ASSERT(HostLocIsGPR(loc));
+    return dwarf_registers[static_cast<size_t>(loc)];
+}
+
+namespace {
+
+struct EhFrameWriter {
+    std::vector<u8> data;
+
+    void U8(u8 value) {
+        data.push_back(value);
+    }
+    void U16(u16 value) {
+        Append(&value, sizeof(value));
+    }
+    void U32(u32 value) {
+        Append(&value, sizeof(value));
+    }
+    void U64(u64 value) {
+        Append(&value, sizeof(value));
+    }
+    void ULEB128(u64 value) {
+        do {
+            u8 byte = value & 0x7F;
+            value >>= 7;
+            U8(value != 0 ? byte | 0x80 : byte);
+        } while (value != 0);
+    }
+    void SLEB128(s64 value) {
+        bool more = true;
+        while (more) {
+            u8 byte = value & 0x7F;
+            value >>= 7;
+            more = !((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)));
+            U8(more ? byte | 0x80 : byte);
+        }
+    }
+    void Append(const void* bytes, size_t size) {
+        const u8* begin = static_cast<const u8*>(bytes);
+        data.insert(data.end(), begin, begin + size);
+    }
+
+    /// Starts a length-prefixed entry. Returns the offset of its length field.
+    size_t BeginEntry() {
+        const size_t offset = data.size();
+        U32(0);
+        return offset;
+    }
+    /// Pads the entry to pointer alignment and fills in its length.
+    void EndEntry(size_t length_offset) {
+        while (data.size() % 8 != 0)
+            U8(DW_CFA_nop);
+        const u32 length = static_cast<u32>(data.size() - length_offset - sizeof(u32));
+        std::memcpy(&data[length_offset], &length, sizeof(u32));
+    }
+
+    /// Moves the location to which the following call frame instructions apply forward by `delta` bytes.
+    void AdvanceLoc(size_t delta) {
+        if (delta == 0) {
+            return;
+        } else if (delta < 0x40) {
+            U8(static_cast<u8>(DW_CFA_advance_loc | delta));
+        } else if (delta <= 0xFF) {
+            U8(DW_CFA_advance_loc1);
+            U8(static_cast<u8>(delta));
+        } else if (delta <= 0xFFFF) {
+            U8(DW_CFA_advance_loc2);
+            U16(static_cast<u16>(delta));
+        } else {
+            U8(DW_CFA_advance_loc4);
+            U32(static_cast<u32>(delta));
+        }
+    }
+    void DefCfaOffset(size_t offset) {
+        U8(DW_CFA_def_cfa_offset);
+        ULEB128(offset);
+    }
+};
+
+/// A stack frame as set up by ABI_Push*RegistersAndAdjustStack and torn down by ABI_Pop*RegistersAndAdjustStack.
+struct Frame {
+    std::vector<HostLoc> gprs; ///< In the order in which they are pushed
+    size_t stack_subtraction;
+
+    template <typename RegisterArrayT>
+    Frame(const RegisterArrayT& regs, size_t stack_subtraction) : stack_subtraction(stack_subtraction) {
+        // XMM registers are saved with movaps after the stack adjustment; as they are not callee-save
+        // on this ABI, no rules are needed to restore them.
+        std::copy_if(regs.begin(), regs.end(), std::back_inserter(gprs), HostLocIsGPR);
+    }
+
+    // Pushes and pops of R8-R15 require a REX prefix.
+    static size_t PushPopSize(u8 dwarf_reg) {
+        return dwarf_reg >= 8 ? 2 : 1;
+    }
+    // sub/add rsp, imm8 or sub/add rsp, imm32
+    size_t AdjustSize() const {
+        return stack_subtraction == 0 ? 0 : stack_subtraction < 0x80 ? 4 : 7;
+    }
+    /// Length in bytes of the epilogue, up to and including the ret which follows it.
+    size_t EpilogueSize() const;
+};
+
+} // anonymous namespace
+
+size_t Frame::EpilogueSize() const {
+    size_t size = AdjustSize() + 1; // ret
+    for (HostLoc loc : gprs)
+        size += PushPopSize(HostLocToDwarfRegister(loc));
+    return size;
+}
+
+static size_t WriteCie(EhFrameWriter& w) {
+    const size_t cie = w.BeginEntry();
+    w.U32(0);                 // CIE id
+    w.U8(1);                  // Version
+    w.Append("zR", 3);        // Augmentation string
+    w.ULEB128(1);             // Code alignment factor
+    w.SLEB128(-8);            // Data alignment factor
+    w.U8(DWARF_REG_RA);       // Return address register
+    w.ULEB128(1);             // Augmentation data length
+    w.U8(DW_EH_PE_absptr);    // FDE pointer encoding
+    w.U8(DW_CFA_def_cfa);     // On entry: CFA = rsp + 8, return address at CFA - 8
+    w.ULEB128(DWARF_REG_RSP);
+    w.ULEB128(8);
+    w.U8(DW_CFA_offset | DWARF_REG_RA);
+    w.ULEB128(1);
+    w.EndEntry(cie);
+    return cie;
+}
+
+/**
+ * Writes an FDE for the code in [begin, end), which starts with a prologue setting up `frame`.
+ * The matching epilogue, followed by a ret, starts at `epilogue`. Any code after that ret is
+ * described as executing within the frame again.
+ * @return The offset of the FDE.
+ */
+static size_t WriteFde(EhFrameWriter& w, size_t cie, const u8* begin, const u8* end, const Frame& frame, const u8* epilogue) {
+    const size_t fde = w.BeginEntry();
+    w.U32(static_cast<u32>(w.data.size() - cie)); // Offset back to the CIE
+    w.U64(reinterpret_cast<u64>(begin));
+    w.U64(static_cast<u64>(end - begin));
+    w.ULEB128(0); // Augmentation data length
+
+    const u8* location = begin;
+    const auto advance_by = [&](size_t size) {
+        w.AdvanceLoc(size);
+        location += size;
+    };
+
+    // Prologue: each rule applies from the end of the instruction which makes it true.
+    size_t cfa_offset = 8;
+    for (HostLoc loc : frame.gprs) {
+        const u8 dwarf_reg = HostLocToDwarfRegister(loc);
+        cfa_offset += 8;
+        advance_by(Frame::PushPopSize(dwarf_reg));
+        w.DefCfaOffset(cfa_offset);
+        w.U8(DW_CFA_offset | dwarf_reg);
+        w.ULEB128(cfa_offset / 8);
+    }
+    if (frame.stack_subtraction != 0) {
+        cfa_offset += frame.stack_subtraction;
+        advance_by(frame.AdjustSize());
+        w.DefCfaOffset(cfa_offset);
+    }
+
+    // Epilogue
+    ASSERT(epilogue >= location && epilogue + frame.EpilogueSize() <= end);
+    w.AdvanceLoc(static_cast<size_t>(epilogue - location));
+    location = epilogue;
+    w.U8(DW_CFA_remember_state);
+    if (frame.stack_subtraction != 0) {
+        cfa_offset -= frame.stack_subtraction;
+        advance_by(frame.AdjustSize());
+        w.DefCfaOffset(cfa_offset);
+    }
+    for (auto iter = frame.gprs.rbegin(); iter != frame.gprs.rend(); ++iter) {
+        cfa_offset -= 8;
+        advance_by(Frame::PushPopSize(HostLocToDwarfRegister(*iter)));
+        w.DefCfaOffset(cfa_offset);
+    }
+    ASSERT(cfa_offset == 8);
+
+    // After the ret
+    if (location + 1 != end) {
+        advance_by(1);
+        w.U8(DW_CFA_restore_state);
+    }
+
+    w.EndEntry(fde);
+    return fde;
+}
+
 struct BlockOfCode::UnwindHandler::Impl final {
+    Impl(std::vector<u8> eh_frame_, std::vector<size_t> fde_offsets_) : eh_frame(std::move(eh_frame_)), fde_offsets(std::move(fde_offsets_)) {
+#ifdef __APPLE__
+        // libunwind expects a pointer to a single FDE.
+        for (size_t offset : fde_offsets)
+            __register_frame(eh_frame.data() + offset);
+#else
+        // libgcc expects a pointer to the start of a complete .eh_frame section.
+        __register_frame(eh_frame.data());
+#endif
+    }
+
+    ~Impl() {
+#ifdef __APPLE__
+        for (size_t offset : fde_offsets)
+            __deregister_frame(eh_frame.data() + offset);
+#else
+        __deregister_frame(eh_frame.data());
+#endif
+    }
+
+private:
+    std::vector<u8> eh_frame;
+    std::vector<size_t> fde_offsets;
 };
 
 BlockOfCode::UnwindHandler::UnwindHandler() = default;
 BlockOfCode::UnwindHandler::~UnwindHandler() = default;
 
-void BlockOfCode::UnwindHandler::Register(BlockOfCode*) {
-    // Do nothing
+/**
+ * Builds and registers an .eh_frame section with one FDE for each memory accessor, and one FDE
+ * covering run_code up to the end of the code space. Emitted blocks run within the frame set up by
+ * the run_code prologue (See: BlockOfCode::GenRunCode), so, as with the Windows unwind information,
+ * all code after that prologue except for the epilogue in return_from_run_code is described as
+ * being inside that frame.
+ */
+void BlockOfCode::UnwindHandler::Register(BlockOfCode* code) {
+    EhFrameWriter w;
+    std::vector<size_t> fde_offsets;
+    const size_t cie = WriteCie(w);
+
+    const Frame accessor_frame{ABI_ALL_CALLER_SAVE, ABI_CallerSaveStackSubtraction()};
+    for (const auto& range : code->memory_accessor_ranges) {
+        const u8* begin = static_cast<const u8*>(range.first);
+        const u8* end = static_cast<const u8*>(range.second);
+        fde_offsets.push_back(WriteFde(w, cie, begin, end, accessor_frame, end - accessor_frame.EpilogueSize()));
+    }
+
+    const Frame run_code_frame{ABI_ALL_CALLEE_SAVE, ABI_CalleeSaveStackSubtraction(SpillFrameSize)};
+    const u8* run_code = reinterpret_cast<const u8*>(code->run_code);
+    const u8* end = code->getCode() + code->maxSize_;
+    const u8* epilogue = static_cast<const u8*>(code->return_from_run_code_without_mxcsr_switch);
+    fde_offsets.push_back(WriteFde(w, cie, run_code, end, run_code_frame, epilogue));
+
+    // Terminator
+    w.U32(0);
+
+    impl = std::make_unique<Impl>(std::move(w.data), std::move(fde_offsets));
 }
 
 } // namespace BackendX64
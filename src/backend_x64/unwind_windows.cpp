@@ -123,26 +123,26 @@ static PrologueInformation GetPrologueInformation() {
     // This is a list of operations that occur in the prologue.
     // The debugger uses this information to retrieve register values and
     // to calculate the size of the stack frame.
-    ret.prolog_size = 89;
-    save_xmm128(89, 15, 0xB0);  // +050  44 0F 29 BC 24 B0 00 00 00  movaps  xmmword ptr [rsp+0B0h],xmm15
-    save_xmm128(80, 14, 0xA0);  // +047  44 0F 29 B4 24 A0 00 00 00  movaps  xmmword ptr [rsp+0A0h],xmm14
-    save_xmm128(71, 13, 0x90);  // +03E  44 0F 29 AC 24 90 00 00 00  movaps  xmmword ptr [rsp+90h],xmm13
-    save_xmm128(62, 12, 0x80);  // +035  44 0F 29 A4 24 80 00 00 00  movaps  xmmword ptr [rsp+80h],xmm12
-    save_xmm128(53, 11, 0x70);  // +02F  44 0F 29 5C 24 70           movaps  xmmword ptr [rsp+70h],xmm11
-    save_xmm128(47, 10, 0x60);  // +029  44 0F 29 54 24 60           movaps  xmmword ptr [rsp+60h],xmm10
-    save_xmm128(41, 9, 0x50);   // +023  44 0F 29 4C 24 50           movaps  xmmword ptr [rsp+50h],xmm9
-    save_xmm128(35, 8, 0x40);   // +01D  44 0F 29 44 24 40           movaps  xmmword ptr [rsp+40h],xmm8
-    save_xmm128(29, 7, 0x30);   // +018  0F 29 7C 24 30              movaps  xmmword ptr [rsp+30h],xmm7
-    save_xmm128(24, 6, 0x20);   // +013  0F 29 74 24 20              movaps  xmmword ptr [rsp+20h],xmm6
-    alloc_large(19, 0xC8);      // +00C  48 81 EC C8 00 00 00        sub     rsp,0C8h
-    push_nonvol(12, UWRC_R15);  // +00A  41 57                       push    r15
-    push_nonvol(10, UWRC_R14);  // +008  41 56                       push    r14
-    push_nonvol(8, UWRC_R13);   // +006  41 55                       push    r13
-    push_nonvol(6, UWRC_R12);   // +004  41 54                       push    r12
-    push_nonvol(4, UWRC_RBP);   // +003  55                          push    rbp
-    push_nonvol(3, UWRC_RDI);   // +002  57                          push    rdi
-    push_nonvol(2, UWRC_RSI);   // +001  56                          push    rsi
-    push_nonvol(1, UWRC_RBX);   // +000  53                          push    rbx
+    ret.prolog_size = 107;
+    save_xmm128(107, 15, 0x2B0); // +062  44 0F 29 BC 24 B0 02 00 00  movaps  xmmword ptr [rsp+2B0h],xmm15
+    save_xmm128(98, 14, 0x2A0);  // +059  44 0F 29 B4 24 A0 02 00 00  movaps  xmmword ptr [rsp+2A0h],xmm14
+    save_xmm128(89, 13, 0x290);  // +050  44 0F 29 AC 24 90 02 00 00  movaps  xmmword ptr [rsp+290h],xmm13
+    save_xmm128(80, 12, 0x280);  // +047  44 0F 29 A4 24 80 02 00 00  movaps  xmmword ptr [rsp+280h],xmm12
+    save_xmm128(71, 11, 0x270);  // +03E  44 0F 29 9C 24 70 02 00 00  movaps  xmmword ptr [rsp+270h],xmm11
+    save_xmm128(62, 10, 0x260);  // +035  44 0F 29 94 24 60 02 00 00  movaps  xmmword ptr [rsp+260h],xmm10
+    save_xmm128(53, 9, 0x250);   // +02C  44 0F 29 8C 24 50 02 00 00  movaps  xmmword ptr [rsp+250h],xmm9
+    save_xmm128(44, 8, 0x240);   // +023  44 0F 29 84 24 40 02 00 00  movaps  xmmword ptr [rsp+240h],xmm8
+    save_xmm128(35, 7, 0x230);   // +01B  0F 29 BC 24 30 02 00 00     movaps  xmmword ptr [rsp+230h],xmm7
+    save_xmm128(27, 6, 0x220);   // +013  0F 29 B4 24 20 02 00 00     movaps  xmmword ptr [rsp+220h],xmm6
+    alloc_large(19, 0x2C8);      // +00C  48 81 EC C8 02 00 00        sub     rsp,2C8h
+    push_nonvol(12, UWRC_R15);   // +00A  41 57                       push    r15
+    push_nonvol(10, UWRC_R14);   // +008  41 56                       push    r14
+    push_nonvol(8, UWRC_R13);    // +006  41 55                       push    r13
+    push_nonvol(6, UWRC_R12);    // +004  41 54                       push    r12
+    push_nonvol(4, UWRC_RBP);    // +003  55                          push    rbp
+    push_nonvol(3, UWRC_RDI);    // +002  57                          push    rdi
+    push_nonvol(2, UWRC_RSI);    // +001  56                          push    rsi
+    push_nonvol(1, UWRC_RBX);    // +000  53                          push    rbx
 
     ret.number_of_unwind_code_entries = ret.unwind_code.size();
 
@@ -16,8 +16,6 @@ Pool::Pool(size_t object_size, size_t initial_pool_size) : object_size(object_si
 }
 
 Pool::~Pool() {
-    std::free(current_slab);
-
     for (char* slab : slabs) {
         std::free(slab);
     }
@@ -25,8 +23,14 @@ Pool::~Pool() {
 
 void* Pool::Alloc() {
     if (remaining == 0) {
-        slabs.emplace_back(current_slab);
-        AllocateNewSlab();
+        if (current_slab_index + 1 < slabs.size()) {
+            // Reuse a slab retained by Reset.
+            current_slab_index++;
+            current_ptr = slabs[current_slab_index];
+            remaining = slab_size;
+        } else {
+            AllocateNewSlab();
+        }
     }
 
     void* ret = static_cast<void*>(current_ptr);
@@ -36,9 +40,16 @@ void* Pool::Alloc() {
     return ret;
 }
 
+void Pool::Reset() {
+    current_slab_index = 0;
+    current_ptr = slabs[0];
+    remaining = slab_size;
+}
+
 void Pool::AllocateNewSlab() {
-    current_slab = static_cast<char*>(std::malloc(object_size * slab_size));
-    current_ptr = current_slab;
+    slabs.emplace_back(static_cast<char*>(std::malloc(object_size * slab_size)));
+    current_slab_index = slabs.size() - 1;
+    current_ptr = slabs.back();
     remaining = slab_size;
 }
 
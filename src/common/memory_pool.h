@@ -27,6 +27,12 @@ public:
     /// Returns a pointer to an `object_size`-bytes block of memory.
     void* Alloc();
 
+    /**
+     * Makes all memory previously returned by Alloc available again, without freeing any slabs.
+     * All objects allocated from this pool must be dead by the time this is called.
+     */
+    void Reset();
+
 private:
     // Allocates a completely new memory slab.
     // Used when an entirely new slab is needed
@@ -35,7 +41,7 @@ private:
 
     size_t object_size;
     size_t slab_size;
-    char* current_slab;
+    size_t current_slab_index;
     char* current_ptr;
     size_t remaining;
     std::vector<char*> slabs;
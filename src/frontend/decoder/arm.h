@@ -192,13 +192,13 @@ std::vector<ArmMatcher<V>> GetArmDecodeTable() {
         INST(&V::arm_LDMDA,       "LDMDA",               "cccc100000w1nnnnxxxxxxxxxxxxxxxx"), // all
         INST(&V::arm_LDMDB,       "LDMDB",               "cccc100100w1nnnnxxxxxxxxxxxxxxxx"), // all
         INST(&V::arm_LDMIB,       "LDMIB",               "cccc100110w1nnnnxxxxxxxxxxxxxxxx"), // all
-        INST(&V::arm_LDM_usr,     "LDM (usr reg)",       "----100--101--------------------"), // all
-        INST(&V::arm_LDM_eret,    "LDM (exce ret)",      "----100--1-1----1---------------"), // all
+        INST(&V::arm_LDM_usr,     "LDM (usr reg)",       "cccc100pu101nnnn0xxxxxxxxxxxxxxx"), // all
+        INST(&V::arm_LDM_eret,    "LDM (exce ret)",      "cccc100pu1w1nnnn1xxxxxxxxxxxxxxx"), // all
         INST(&V::arm_STM,         "STM",                 "cccc100010w0nnnnxxxxxxxxxxxxxxxx"), // all
         INST(&V::arm_STMDA,       "STMDA",               "cccc100000w0nnnnxxxxxxxxxxxxxxxx"), // all
         INST(&V::arm_STMDB,       "STMDB",               "cccc100100w0nnnnxxxxxxxxxxxxxxxx"), // all
         INST(&V::arm_STMIB,       "STMIB",               "cccc100110w0nnnnxxxxxxxxxxxxxxxx"), // all
-        INST(&V::arm_STM_usr,     "STM (usr reg)",       "----100--100--------------------"), // all
+        INST(&V::arm_STM_usr,     "STM (usr reg)",       "cccc100pu100nnnnxxxxxxxxxxxxxxxx"), // all
 
         // Miscellaneous instructions
         INST(&V::arm_CLZ,         "CLZ",                 "cccc000101101111dddd11110001mmmm"), // v5
@@ -306,13 +306,13 @@ std::vector<ArmMatcher<V>> GetArmDecodeTable() {
         INST(&V::arm_QDSUB,       "QDSUB",               "cccc00010110nnnndddd00000101mmmm"), // v5xP
 
         // Status Register Access instructions
-        INST(&V::arm_CPS,         "CPS",                 "111100010000---00000000---0-----"), // v6
+        INST(&V::arm_CPS,         "CPS",                 "111100010000iiM00000000AIF0ooooo"), // v6
         INST(&V::arm_SETEND,      "SETEND",              "1111000100000001000000e000000000"), // v6
-        INST(&V::arm_MRS,         "MRS",                 "cccc000100001111dddd000000000000"), // v3
-        INST(&V::arm_MSR_imm,     "MSR (imm)",           "cccc00110010mm001111rrrrvvvvvvvv"), // v3
-        INST(&V::arm_MSR_reg,     "MSR (reg)",           "cccc00010010mm00111100000000nnnn"), // v3
-        INST(&V::arm_RFE,         "RFE",                 "----0001101-0000---------110----"), // v6
-        INST(&V::arm_SRS,         "SRS",                 "0000011--0-00000000000000001----"), // v6
+        INST(&V::arm_MRS,         "MRS",                 "cccc00010R001111dddd000000000000"), // v3
+        INST(&V::arm_MSR_imm,     "MSR (imm)",           "cccc00110R10mmmm1111rrrrvvvvvvvv"), // v3
+        INST(&V::arm_MSR_reg,     "MSR (reg)",           "cccc00010R10mmmm111100000000nnnn"), // v3
+        INST(&V::arm_RFE,         "RFE",                 "1111100pu0w1nnnn0000101000000000"), // v6
+        INST(&V::arm_SRS,         "SRS",                 "1111100pu1w0110100000101000ooooo"), // v6
 
 #undef INST
 
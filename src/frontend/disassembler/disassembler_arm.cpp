@@ -83,6 +83,21 @@ public:
         return "<internal error>";
     }
 
+    std::string AddressingModeToString(bool P, bool U) {
+        if (U)
+            return P ? "ib" : "ia";
+        return P ? "db" : "da";
+    }
+
+    std::string MSRSpecRegToString(bool R, int mask) {
+        if (!R && (mask & 0b0011) == 0) {
+            bool write_nzcvq = Common::Bit<3>(mask);
+            bool write_g = Common::Bit<2>(mask);
+            return fmt::format("apsr_{}{}", write_nzcvq ? "nzcvq" : "", write_g ? "g" : "");
+        }
+        return fmt::format("{}_{}{}{}{}", R ? "spsr" : "cpsr", Common::Bit<3>(mask) ? "f" : "", Common::Bit<2>(mask) ? "s" : "", Common::Bit<1>(mask) ? "x" : "", Common::Bit<0>(mask) ? "c" : "");
+    }
+
     std::string FPRegStr(bool dp_operation, size_t base, bool bit) {
         size_t reg_num;
         if (dp_operation) {
@@ -529,8 +544,12 @@ public:
     std::string arm_LDMIB(Cond cond, bool W, Reg n, RegList list) {
         return fmt::format("ldmib{} {}{}, {{{}}}", CondToString(cond), n, W ? "!" : "", list);
     }
-    std::string arm_LDM_usr() { return "ice"; }
-    std::string arm_LDM_eret() { return "ice"; }
+    std::string arm_LDM_usr(Cond cond, bool P, bool U, Reg n, RegList list) {
+        return fmt::format("ldm{}{} {}, {{{}}}^", AddressingModeToString(P, U), CondToString(cond), n, list);
+    }
+    std::string arm_LDM_eret(Cond cond, bool P, bool U, bool W, Reg n, RegList list) {
+        return fmt::format("ldm{}{} {}{}, {{{}}}^", AddressingModeToString(P, U), CondToString(cond), n, W ? "!" : "", list);
+    }
     std::string arm_STM(Cond cond, bool W, Reg n, RegList list) {
         return fmt::format("stm{} {}{}, {{{}}}", CondToString(cond), n, W ? "!" : "", list);
     }
@@ -543,7 +562,9 @@ public:
     std::string arm_STMIB(Cond cond, bool W, Reg n, RegList list) {
         return fmt::format("stmib{} {}{}, {{{}}}", CondToString(cond), n, W ? "!" : "", list);
     }
-    std::string arm_STM_usr() { return "ice"; }
+    std::string arm_STM_usr(Cond cond, bool P, bool U, Reg n, RegList list) {
+        return fmt::format("stm{}{} {}, {{{}}}^", AddressingModeToString(P, U), CondToString(cond), n, list);
+    }
 
     // Miscellaneous instructions
     std::string arm_CLZ(Cond cond, Reg d, Reg m) {
@@ -836,25 +857,30 @@ public:
     }
 
     // Status register access instructions
-    std::string arm_CPS() { return "ice"; }
-    std::string arm_MRS(Cond cond, Reg d) {
-        return fmt::format("mrs{} {}, apsr", CondToString(cond), d);
+    std::string arm_CPS(int imod, bool M, bool A, bool I, bool F, Imm5 mode) {
+        const std::string mode_str = M ? fmt::format("#{}", mode) : "";
+        if (imod == 0b00)
+            return fmt::format("cps {}", mode_str);
+        return fmt::format("cps{} {}{}{}{}{}", imod == 0b10 ? "ie" : "id", A ? "a" : "", I ? "i" : "", F ? "f" : "", M ? ", " : "", mode_str);
+    }
+    std::string arm_MRS(Cond cond, bool R, Reg d) {
+        return fmt::format("mrs{} {}, {}", CondToString(cond), d, R ? "spsr" : "apsr");
     }
-    std::string arm_MSR_imm(Cond cond, int mask, int rotate, Imm8 imm8) {
-        bool write_nzcvq = Common::Bit<1>(mask);
-        bool write_g = Common::Bit<0>(mask);
-        return fmt::format("msr{} apsr_{}{}, #{}", CondToString(cond), write_nzcvq ? "nzcvq" : "", write_g ? "g" : "", ArmExpandImm(rotate, imm8));
+    std::string arm_MSR_imm(Cond cond, bool R, int mask, int rotate, Imm8 imm8) {
+        return fmt::format("msr{} {}, #{}", CondToString(cond), MSRSpecRegToString(R, mask), ArmExpandImm(rotate, imm8));
     }
-    std::string arm_MSR_reg(Cond cond, int mask, Reg n) {
-        bool write_nzcvq = Common::Bit<1>(mask);
-        bool write_g = Common::Bit<0>(mask);
-        return fmt::format("msr{} apsr_{}{}, {}", CondToString(cond), write_nzcvq ? "nzcvq" : "", write_g ? "g" : "", n);
+    std::string arm_MSR_reg(Cond cond, bool R, int mask, Reg n) {
+        return fmt::format("msr{} {}, {}", CondToString(cond), MSRSpecRegToString(R, mask), n);
+    }
+    std::string arm_RFE(bool P, bool U, bool W, Reg n) {
+        return fmt::format("rfe{} {}{}", AddressingModeToString(P, U), n, W ? "!" : "");
     }
-    std::string arm_RFE() { return "ice"; }
     std::string arm_SETEND(bool E) {
         return E ? "setend be" : "setend le";
     }
-    std::string arm_SRS() { return "ice"; }
+    std::string arm_SRS(bool P, bool U, bool W, Imm5 mode) {
+        return fmt::format("srs{} sp{}, #{}", AddressingModeToString(P, U), W ? "!" : "", mode);
+    }
 
     // Floating point arithmetic instructions
     std::string vfp2_VADD(Cond cond, bool D, size_t Vn, size_t Vd, bool sz, bool N, bool M, size_t Vm) {
@@ -19,6 +19,17 @@
 namespace Dynarmic {
 namespace IR {
 
+/// Number of instructions per slab in a pool owned by a block. Most blocks are short.
+constexpr size_t OWNED_POOL_SLAB_SIZE = 64;
+
+Block::Block(const LocationDescriptor& location, Common::Pool* instruction_pool) : location(location) {
+    if (!instruction_pool) {
+        owned_instruction_alloc_pool = std::make_unique<Common::Pool>(sizeof(Inst), OWNED_POOL_SLAB_SIZE);
+        instruction_pool = owned_instruction_alloc_pool.get();
+    }
+    instruction_alloc_pool = instruction_pool;
+}
+
 void Block::AppendNewInst(Opcode opcode, std::initializer_list<IR::Value> args) {
     IR::Inst* inst = new(instruction_alloc_pool->Alloc()) IR::Inst(opcode);
     DEBUG_ASSERT(args.size() == inst->NumArgs());
@@ -120,6 +131,9 @@ static std::string TerminalToString(const Terminal& terminal_variant) {
         auto terminal = boost::get<IR::Term::CheckHalt>(terminal_variant);
         return fmt::format("CheckHalt{{{}}}", TerminalToString(terminal.else_));
     }
+    case 8: {
+        return "IndirectBranchHint{}";
+    }
     default:
         return "<invalid terminal>";
     }
@@ -23,7 +23,7 @@
 namespace Dynarmic {
 namespace IR {
 
-enum class Opcode;
+enum class Opcode : u8;
 
 /**
  * A basic block. It consists of zero or more instructions followed by exactly one terminal.
@@ -40,7 +40,12 @@ public:
     using reverse_iterator       = InstructionList::reverse_iterator;
     using const_reverse_iterator = InstructionList::const_reverse_iterator;
 
-    explicit Block(const LocationDescriptor& location) : location(location) {}
+    /**
+     * @param location           Starting location of this basic block.
+     * @param instruction_pool   Pool from which to allocate instructions, which must outlive this block.
+     *                           If null, the block allocates instructions from a pool of its own.
+     */
+    explicit Block(const LocationDescriptor& location, Common::Pool* instruction_pool = nullptr);
 
     bool                   empty()   const { return instructions.empty();   }
     size_type              size()    const { return instructions.size();    }
@@ -125,8 +130,10 @@ private:
 
     /// List of instructions in this block.
     InstructionList instructions;
+    /// Memory pool for instruction list, if this block owns one
+    std::unique_ptr<Common::Pool> owned_instruction_alloc_pool;
     /// Memory pool for instruction list
-    std::unique_ptr<Common::Pool> instruction_alloc_pool = std::make_unique<Common::Pool>(sizeof(Inst), 4096);
+    Common::Pool* instruction_alloc_pool;
     /// Terminal instruction of this block.
     Terminal terminal = Term::Invalid{};
 
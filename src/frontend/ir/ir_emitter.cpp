@@ -4,7 +4,10 @@
  * General Public License version 2 or any later version.
  */
 
+#include <utility>
+
 #include "common/assert.h"
+#include "common/bit_util.h"
 #include "frontend/ir/ir_emitter.h"
 #include "frontend/ir/opcodes.h"
 
@@ -105,6 +108,12 @@ void IREmitter::CallSupervisor(const Value& value) {
     Inst(Opcode::CallSupervisor, {value});
 }
 
+void IREmitter::InterpretInstruction(u32 instruction_size) {
+    const u32 pc = current_location.PC();
+    const u32 cycles_so_far = static_cast<u32>(block.CycleCount() + 1);
+    Inst(Opcode::InterpretInstruction, {Imm32(pc), Imm32(pc + instruction_size), Imm32(cycles_so_far)});
+}
+
 void IREmitter::PushRSB(const LocationDescriptor& return_location) {
     Inst(Opcode::PushRSB, {Value(return_location.UniqueHash())});
 }
@@ -117,6 +126,18 @@ void IREmitter::SetCpsr(const Value& value) {
     Inst(Opcode::SetCpsr, {value});
 }
 
+void IREmitter::SetCpsrWithModeSwitch(const Value& value) {
+    Inst(Opcode::SetCpsrWithModeSwitch, {value});
+}
+
+Value IREmitter::GetSpsr() {
+    return Inst(Opcode::GetSpsr, {});
+}
+
+void IREmitter::SetSpsr(const Value& value) {
+    Inst(Opcode::SetSpsr, {value});
+}
+
 Value IREmitter::GetCFlag() {
     return Inst(Opcode::GetCFlag, {});
 }
@@ -639,6 +660,111 @@ Value IREmitter::ExclusiveWriteMemory64(const Value& vaddr, const Value& value_l
     }
 }
 
+Value IREmitter::SwapMemory8(const Value& vaddr, const Value& value) {
+    return Inst(Opcode::SwapMemory8, {vaddr, value});
+}
+
+Value IREmitter::SwapMemory32(const Value& vaddr, const Value& value) {
+    if (current_location.EFlag()) {
+        auto v = ByteReverseWord(value);
+        return ByteReverseWord(Inst(Opcode::SwapMemory32, {vaddr, v}));
+    } else {
+        return Inst(Opcode::SwapMemory32, {vaddr, value});
+    }
+}
+
+void IREmitter::ReadMemoryToRegisters(const Value& vaddr, Arm::RegList list) {
+    ASSERT(!Common::Bit<15>(list));
+    if (list == 0)
+        return;
+
+    if (!current_location.EFlag()) {
+        Inst(Opcode::ReadMemoryToRegisters, {vaddr, Imm32(list)});
+        return;
+    }
+
+    // Big-endian transfers reverse each word, so are done one register at a time.
+    Value address = vaddr;
+    for (size_t i = 0; i <= 14; i++) {
+        if (Common::Bit(i, list)) {
+            SetRegister(static_cast<Arm::Reg>(i), ReadMemory32(address));
+            address = Add(address, Imm32(4));
+        }
+    }
+}
+
+void IREmitter::WriteMemoryFromRegisters(const Value& vaddr, Arm::RegList list) {
+    ASSERT(!Common::Bit<15>(list));
+    if (list == 0)
+        return;
+
+    if (!current_location.EFlag()) {
+        Inst(Opcode::WriteMemoryFromRegisters, {vaddr, Imm32(list)});
+        return;
+    }
+
+    // Big-endian transfers reverse each word, so are done one register at a time.
+    Value address = vaddr;
+    for (size_t i = 0; i <= 14; i++) {
+        if (Common::Bit(i, list)) {
+            WriteMemory32(address, GetRegister(static_cast<Arm::Reg>(i)));
+            address = Add(address, Imm32(4));
+        }
+    }
+}
+
+void IREmitter::ReadMemoryToExtendedRegisters(const Value& vaddr, Arm::ExtReg first, size_t count) {
+    ASSERT(count >= 1 && Arm::RegNumber(first) + count <= 32);
+
+    if (!current_location.EFlag()) {
+        Inst(Opcode::ReadMemoryToExtendedRegisters, {vaddr, Value(first), Imm8(u8(count))});
+        return;
+    }
+
+    // Big-endian transfers reverse each word, so are done one register at a time.
+    Value address = vaddr;
+    for (size_t i = 0; i < count; i++) {
+        if (Arm::IsDoubleExtReg(first)) {
+            auto lo = ReadMemory32(address);
+            address = Add(address, Imm32(4));
+            auto hi = ReadMemory32(address);
+            address = Add(address, Imm32(4));
+            std::swap(lo, hi);
+            SetExtendedRegister(first + i, TransferToFP64(Pack2x32To1x64(lo, hi)));
+        } else {
+            SetExtendedRegister(first + i, TransferToFP32(ReadMemory32(address)));
+            address = Add(address, Imm32(4));
+        }
+    }
+}
+
+void IREmitter::WriteMemoryFromExtendedRegisters(const Value& vaddr, Arm::ExtReg first, size_t count) {
+    ASSERT(count >= 1 && Arm::RegNumber(first) + count <= 32);
+
+    if (!current_location.EFlag()) {
+        Inst(Opcode::WriteMemoryFromExtendedRegisters, {vaddr, Value(first), Imm8(u8(count))});
+        return;
+    }
+
+    // Big-endian transfers reverse each word, so are done one register at a time.
+    Value address = vaddr;
+    for (size_t i = 0; i < count; i++) {
+        if (Arm::IsDoubleExtReg(first)) {
+            auto value = TransferFromFP64(GetExtendedRegister(first + i));
+            auto lo = LeastSignificantWord(value);
+            auto hi = MostSignificantWord(value).result;
+            std::swap(lo, hi);
+            WriteMemory32(address, lo);
+            address = Add(address, Imm32(4));
+            WriteMemory32(address, hi);
+            address = Add(address, Imm32(4));
+        } else {
+            WriteMemory32(address, TransferFromFP32(GetExtendedRegister(first + i)));
+            address = Add(address, Imm32(4));
+        }
+    }
+}
+
 void IREmitter::Breakpoint() {
     Inst(Opcode::Breakpoint, {});
 }
@@ -24,7 +24,7 @@
 namespace Dynarmic {
 namespace IR {
 
-enum class Opcode;
+enum class Opcode : u8;
 
 /**
  * Convenience class to construct a basic block of the intermediate representation.
@@ -33,7 +33,7 @@ enum class Opcode;
  */
 class IREmitter {
 public:
-    explicit IREmitter(LocationDescriptor descriptor) : block(descriptor), current_location(descriptor) {}
+    explicit IREmitter(LocationDescriptor descriptor, Common::Pool* instruction_pool = nullptr) : block(descriptor, instruction_pool), current_location(descriptor) {}
 
     Block block;
     LocationDescriptor current_location;
@@ -78,10 +78,14 @@ public:
     void BXWritePC(const Value& value);
     void LoadWritePC(const Value& value);
     void CallSupervisor(const Value& value);
+    void InterpretInstruction(u32 instruction_size);
     void PushRSB(const LocationDescriptor& return_location);
 
     Value GetCpsr();
     void SetCpsr(const Value& value);
+    void SetCpsrWithModeSwitch(const Value& value);
+    Value GetSpsr();
+    void SetSpsr(const Value& value);
     Value GetCFlag();
     void SetNFlag(const Value& value);
     void SetZFlag(const Value& value);
@@ -199,6 +203,18 @@ public:
     Value ExclusiveWriteMemory16(const Value& vaddr, const Value& value);
     Value ExclusiveWriteMemory32(const Value& vaddr, const Value& value);
     Value ExclusiveWriteMemory64(const Value& vaddr, const Value& value_lo, const Value& value_hi);
+    /// Atomically stores value to vaddr, returning the previous contents (SWP, SWPB).
+    Value SwapMemory8(const Value& vaddr, const Value& value);
+    Value SwapMemory32(const Value& vaddr, const Value& value);
+
+    /// Loads consecutive words starting at vaddr into each of R0-R14 in list, in ascending order.
+    void ReadMemoryToRegisters(const Value& vaddr, Arm::RegList list);
+    /// Stores each of R0-R14 in list, in ascending order, to consecutive words starting at vaddr.
+    void WriteMemoryFromRegisters(const Value& vaddr, Arm::RegList list);
+    /// Loads count consecutive extension registers starting at first (VLDM).
+    void ReadMemoryToExtendedRegisters(const Value& vaddr, Arm::ExtReg first, size_t count);
+    /// Stores count consecutive extension registers starting at first (VSTM).
+    void WriteMemoryFromExtendedRegisters(const Value& vaddr, Arm::ExtReg first, size_t count);
 
     void Breakpoint();
 
@@ -74,7 +74,7 @@ public:
 
     u64 UniqueHash() const {
         // This value MUST BE UNIQUE.
-        // This calculation has to match up with EmitX64::EmitTerminalPopRSBHint
+        // This calculation has to match up with EmitCurrentLocationUniqueHash in emit_x64.cpp
         u64 pc_u64 = u64(arm_pc);
         u64 fpscr_u64 = u64(fpscr.Value()) << 32;
         u64 t_u64 = cpsr.T() ? (1ull << 35) : 0;
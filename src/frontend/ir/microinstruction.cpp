@@ -43,6 +43,10 @@ bool Inst::IsSharedMemoryRead() const {
     case Opcode::ReadMemory16:
     case Opcode::ReadMemory32:
     case Opcode::ReadMemory64:
+    case Opcode::SwapMemory8:
+    case Opcode::SwapMemory32:
+    case Opcode::ReadMemoryToRegisters:
+    case Opcode::ReadMemoryToExtendedRegisters:
         return true;
 
     default:
@@ -56,6 +60,10 @@ bool Inst::IsSharedMemoryWrite() const {
     case Opcode::WriteMemory16:
     case Opcode::WriteMemory32:
     case Opcode::WriteMemory64:
+    case Opcode::SwapMemory8:
+    case Opcode::SwapMemory32:
+    case Opcode::WriteMemoryFromRegisters:
+    case Opcode::WriteMemoryFromExtendedRegisters:
         return true;
 
     default:
@@ -95,6 +103,8 @@ bool Inst::IsMemoryReadOrWrite() const {
 bool Inst::ReadsFromCPSR() const {
     switch (op) {
     case Opcode::GetCpsr:
+    case Opcode::InterpretInstruction:
+    case Opcode::SetCpsrWithModeSwitch:
     case Opcode::GetNFlag:
     case Opcode::GetZFlag:
     case Opcode::GetCFlag:
@@ -110,6 +120,8 @@ bool Inst::ReadsFromCPSR() const {
 bool Inst::WritesToCPSR() const {
     switch (op) {
     case Opcode::SetCpsr:
+    case Opcode::InterpretInstruction:
+    case Opcode::SetCpsrWithModeSwitch:
     case Opcode::SetNFlag:
     case Opcode::SetZFlag:
     case Opcode::SetCFlag:
@@ -126,8 +138,13 @@ bool Inst::WritesToCPSR() const {
 bool Inst::ReadsFromCoreRegister() const {
     switch (op) {
     case Opcode::GetRegister:
+    case Opcode::InterpretInstruction:
+    case Opcode::GetSpsr:
+    case Opcode::SetCpsrWithModeSwitch:
     case Opcode::GetExtendedRegister32:
     case Opcode::GetExtendedRegister64:
+    case Opcode::WriteMemoryFromRegisters:
+    case Opcode::WriteMemoryFromExtendedRegisters:
         return true;
 
     default:
@@ -138,9 +155,14 @@ bool Inst::ReadsFromCoreRegister() const {
 bool Inst::WritesToCoreRegister() const {
     switch (op) {
     case Opcode::SetRegister:
+    case Opcode::InterpretInstruction:
     case Opcode::SetExtendedRegister32:
     case Opcode::SetExtendedRegister64:
     case Opcode::BXWritePC:
+    case Opcode::SetCpsrWithModeSwitch:
+    case Opcode::SetSpsr:
+    case Opcode::ReadMemoryToRegisters:
+    case Opcode::ReadMemoryToExtendedRegisters:
         return true;
 
     default:
@@ -151,6 +173,7 @@ bool Inst::WritesToCoreRegister() const {
 bool Inst::ReadsFromFPSCR() const {
     switch (op) {
     case Opcode::GetFpscr:
+    case Opcode::InterpretInstruction:
     case Opcode::GetFpscrNZCV:
     case Opcode::FPAbs32:
     case Opcode::FPAbs64:
@@ -178,6 +201,7 @@ bool Inst::ReadsFromFPSCR() const {
 bool Inst::WritesToFPSCR() const {
     switch (op) {
     case Opcode::SetFpscr:
+    case Opcode::InterpretInstruction:
     case Opcode::SetFpscrNZCV:
     case Opcode::FPAbs32:
     case Opcode::FPAbs64:
@@ -203,13 +227,15 @@ bool Inst::WritesToFPSCR() const {
 }
 
 bool Inst::CausesCPUException() const {
-    return op == Opcode::Breakpoint ||
-           op == Opcode::CallSupervisor;
+    return op == Opcode::Breakpoint     ||
+           op == Opcode::CallSupervisor ||
+           op == Opcode::InterpretInstruction;
 }
 
 bool Inst::AltersExclusiveState() const {
-    return op == Opcode::ClearExclusive ||
-           op == Opcode::SetExclusive   ||
+    return op == Opcode::ClearExclusive       ||
+           op == Opcode::SetExclusive         ||
+           op == Opcode::InterpretInstruction ||
            IsExclusiveMemoryWrite();
 }
 
@@ -94,12 +94,19 @@ public:
 
     void ReplaceUsesWith(Value& replacement);
 
+    /// Gets the block-local index most recently assigned to this instruction with SetIndex.
+    u32 GetIndex() const { return index; }
+    /// Assigns a block-local index to this instruction, for use by passes that keep per-instruction side tables.
+    void SetIndex(u32 value) { index = value; }
+
 private:
     void Use(Value& value);
     void UndoUse(Value& value);
 
+    // Members are ordered to avoid padding.
     Opcode op;
-    size_t use_count = 0;
+    u32 index = 0;
+    u32 use_count = 0;
     std::array<Value, 3> args;
 
     // Pointers to related pseudooperations:
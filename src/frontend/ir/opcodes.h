@@ -14,8 +14,9 @@ namespace IR {
 /**
  * The Opcodes of our intermediate representation.
  * Type signatures for each opcode can be found in opcodes.inc
+ * This is a single byte to keep IR::Inst small.
  */
-enum class Opcode {
+enum class Opcode : u8 {
 #define OPCODE(name, type, ...) name,
 #include "opcodes.inc"
 #undef OPCODE
@@ -27,7 +28,7 @@ constexpr size_t OpcodeCount = static_cast<size_t>(Opcode::NUM_OPCODE);
 /**
  * The intermediate representation is typed. These are the used by our IR.
  */
-enum class Type {
+enum class Type : u8 {
     Void,
     RegRef,
     ExtRegRef,
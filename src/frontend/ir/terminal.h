@@ -64,6 +64,15 @@ struct LinkBlockFast {
  */
 struct PopRSBHint {};
 
+/**
+ * This terminal instruction predicts the target of an indirect branch using a small cache
+ * of recently seen targets private to this branch site. If none of the cached targets
+ * match R15, control is returned to the dispatcher and the cache is updated.
+ * This is an optimization for computed branches. A backend that doesn't support this
+ * optimization may choose to implement this exactly as ReturnToDispatch.
+ */
+struct IndirectBranchHint {};
+
 struct If;
 struct CheckHalt;
 /// A Terminal is the terminal instruction in a MicroBlock.
@@ -75,7 +84,8 @@ using Terminal = boost::variant<
         LinkBlockFast,
         PopRSBHint,
         boost::recursive_wrapper<If>,
-        boost::recursive_wrapper<CheckHalt>
+        boost::recursive_wrapper<CheckHalt>,
+        IndirectBranchHint
 >;
 
 /**
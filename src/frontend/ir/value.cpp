@@ -4,6 +4,9 @@
  * General Public License version 2 or any later version.
  */
 
+#include <cstring>
+#include <type_traits>
+
 #include "common/assert.h"
 #include "frontend/ir/microinstruction.h"
 #include "frontend/ir/value.h"
@@ -11,37 +14,50 @@
 namespace Dynarmic {
 namespace IR {
 
+template <typename T>
+void Value::Store(T value) {
+    static_assert(std::is_trivially_copyable<T>::value && sizeof(T) <= sizeof(inner), "Invalid immediate type");
+    std::memcpy(inner.data(), &value, sizeof(T));
+}
+
+template <typename T>
+T Value::Load() const {
+    T value;
+    std::memcpy(&value, inner.data(), sizeof(T));
+    return value;
+}
+
 Value::Value(Inst* value) : type(Type::Opaque) {
-    inner.inst = value;
+    Store<Inst*>(value);
 }
 
 Value::Value(Arm::Reg value) : type(Type::RegRef) {
-    inner.imm_regref = value;
+    Store<Arm::Reg>(value);
 }
 
 Value::Value(Arm::ExtReg value) : type(Type::ExtRegRef) {
-    inner.imm_extregref = value;
+    Store<Arm::ExtReg>(value);
 }
 
 Value::Value(bool value) : type(Type::U1) {
-    inner.imm_u1 = value;
+    Store<bool>(value);
 }
 
 Value::Value(u8 value) : type(Type::U8) {
-    inner.imm_u8 = value;
+    Store<u8>(value);
 }
 
 Value::Value(u32 value) : type(Type::U32) {
-    inner.imm_u32 = value;
+    Store<u32>(value);
 }
 
 Value::Value(u64 value) : type(Type::U64) {
-    inner.imm_u64 = value;
+    Store<u64>(value);
 }
 
 bool Value::IsImmediate() const {
     if (type == Type::Opaque)
-        return inner.inst->GetOpcode() == Opcode::Identity ? inner.inst->GetArg(0).IsImmediate() : false;
+        return Load<Inst*>()->GetOpcode() == Opcode::Identity ? Load<Inst*>()->GetArg(0).IsImmediate() : false;
     return true;
 }
 
@@ -51,10 +67,10 @@ bool Value::IsEmpty() const {
 
 Type Value::GetType() const {
     if (type == Type::Opaque) {
-        if (inner.inst->GetOpcode() == Opcode::Identity) {
-            return inner.inst->GetArg(0).GetType();
+        if (Load<Inst*>()->GetOpcode() == Opcode::Identity) {
+            return Load<Inst*>()->GetArg(0).GetType();
         } else {
-            return inner.inst->GetType();
+            return Load<Inst*>()->GetType();
         }
     }
     return type;
@@ -62,45 +78,45 @@ Type Value::GetType() const {
 
 Arm::Reg Value::GetRegRef() const {
     DEBUG_ASSERT(type == Type::RegRef);
-    return inner.imm_regref;
+    return Load<Arm::Reg>();
 }
 
 Arm::ExtReg Value::GetExtRegRef() const {
     DEBUG_ASSERT(type == Type::ExtRegRef);
-    return inner.imm_extregref;
+    return Load<Arm::ExtReg>();
 }
 
 Inst* Value::GetInst() const {
     DEBUG_ASSERT(type == Type::Opaque);
-    return inner.inst;
+    return Load<Inst*>();
 }
 
 bool Value::GetU1() const {
-    if (type == Type::Opaque && inner.inst->GetOpcode() == Opcode::Identity)
-        return inner.inst->GetArg(0).GetU1();
+    if (type == Type::Opaque && Load<Inst*>()->GetOpcode() == Opcode::Identity)
+        return Load<Inst*>()->GetArg(0).GetU1();
     DEBUG_ASSERT(type == Type::U1);
-    return inner.imm_u1;
+    return Load<bool>();
 }
 
 u8 Value::GetU8() const {
-    if (type == Type::Opaque && inner.inst->GetOpcode() == Opcode::Identity)
-        return inner.inst->GetArg(0).GetU8();
+    if (type == Type::Opaque && Load<Inst*>()->GetOpcode() == Opcode::Identity)
+        return Load<Inst*>()->GetArg(0).GetU8();
     DEBUG_ASSERT(type == Type::U8);
-    return inner.imm_u8;
+    return Load<u8>();
 }
 
 u32 Value::GetU32() const {
-    if (type == Type::Opaque && inner.inst->GetOpcode() == Opcode::Identity)
-        return inner.inst->GetArg(0).GetU32();
+    if (type == Type::Opaque && Load<Inst*>()->GetOpcode() == Opcode::Identity)
+        return Load<Inst*>()->GetArg(0).GetU32();
     DEBUG_ASSERT(type == Type::U32);
-    return inner.imm_u32;
+    return Load<u32>();
 }
 
 u64 Value::GetU64() const {
-    if (type == Type::Opaque && inner.inst->GetOpcode() == Opcode::Identity)
-        return inner.inst->GetArg(0).GetU64();
+    if (type == Type::Opaque && Load<Inst*>()->GetOpcode() == Opcode::Identity)
+        return Load<Inst*>()->GetArg(0).GetU64();
     DEBUG_ASSERT(type == Type::U64);
-    return inner.imm_u64;
+    return Load<u64>();
 }
 
 } // namespace IR
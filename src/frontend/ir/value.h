@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "common/common_types.h"
 #include "frontend/arm/types.h"
 
@@ -42,17 +44,17 @@ public:
     u64 GetU64() const;
 
 private:
+    template <typename T>
+    void Store(T value);
+    template <typename T>
+    T Load() const;
+
     Type type;
 
-    union {
-        Inst* inst; // type == Type::Opaque
-        Arm::Reg imm_regref;
-        Arm::ExtReg imm_extregref;
-        bool imm_u1;
-        u8 imm_u8;
-        u32 imm_u32;
-        u64 imm_u64;
-    } inner;
+    // Holds an Inst* if type == Type::Opaque, or otherwise an immediate of the given type.
+    // This is stored as 32-bit words rather than as a union of the possible members so that
+    // Value only requires 4-byte alignment: three of these then pack tightly into an IR::Inst.
+    std::array<u32, 2> inner{};
 };
 
 } // namespace IR
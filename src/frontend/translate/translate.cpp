@@ -11,11 +11,18 @@
 namespace Dynarmic {
 namespace Arm {
 
-IR::Block TranslateArm(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32);
-IR::Block TranslateThumb(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32);
+IR::Block TranslateArm(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32, Common::Pool* instruction_pool);
+IR::Block TranslateThumb(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32, Common::Pool* instruction_pool);
 
-IR::Block Translate(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32) {
-    return (descriptor.TFlag() ? TranslateThumb : TranslateArm)(descriptor, memory_read_32);
+const char* GetArmInstructionName(IR::LocationDescriptor location, MemoryRead32FuncType memory_read_32);
+const char* GetThumbInstructionName(IR::LocationDescriptor location, MemoryRead32FuncType memory_read_32);
+
+IR::Block Translate(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32, Common::Pool* instruction_pool) {
+    return (descriptor.TFlag() ? TranslateThumb : TranslateArm)(descriptor, memory_read_32, instruction_pool);
+}
+
+const char* GetInstructionName(IR::LocationDescriptor location, MemoryRead32FuncType memory_read_32) {
+    return (location.TFlag() ? GetThumbInstructionName : GetArmInstructionName)(location, memory_read_32);
 }
 
 } // namespace Arm
@@ -9,6 +9,10 @@
 
 namespace Dynarmic {
 
+namespace Common {
+class Pool;
+} // namespace Common
+
 namespace IR {
 class Block;
 class LocationDescriptor;
@@ -24,9 +28,17 @@ using MemoryRead32FuncType = u32 (*)(u32 vaddr);
  * This function translates instructions in memory into our intermediate representation.
  * @param descriptor The starting location of the basic block. Includes information like PC, Thumb state, &c.
  * @param memory_read_32 The function we should use to read emulated memory.
+ * @param instruction_pool The pool from which to allocate the block's instructions (See: IR::Block::Block).
  * @return A translated basic block in the intermediate representation.
  */
-IR::Block Translate(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32);
+IR::Block Translate(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32, Common::Pool* instruction_pool = nullptr);
+
+/**
+ * Looks up the name the decoder gives to an instruction in memory (e.g.: "SXTAB16").
+ * @param location The location of the instruction. Includes information like PC, Thumb state, &c.
+ * @param memory_read_32 The function we should use to read emulated memory.
+ */
+const char* GetInstructionName(IR::LocationDescriptor location, MemoryRead32FuncType memory_read_32);
 
 } // namespace Arm
 } // namespace Dynarmic
@@ -28,8 +28,8 @@ static bool CondCanContinue(ConditionalState cond_state, const IR::IREmitter& ir
     return std::all_of(ir.block.begin(), ir.block.end(), [](const IR::Inst& inst) { return !inst.WritesToCPSR(); });
 }
 
-IR::Block TranslateArm(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32) {
-    ArmTranslatorVisitor visitor{descriptor};
+IR::Block TranslateArm(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32, Common::Pool* instruction_pool) {
+    ArmTranslatorVisitor visitor{descriptor, instruction_pool};
 
     bool should_continue = true;
     while (should_continue && CondCanContinue(visitor.cond_state, visitor.ir)) {
@@ -63,6 +63,17 @@ IR::Block TranslateArm(IR::LocationDescriptor descriptor, MemoryRead32FuncType m
     return std::move(visitor.ir.block);
 }
 
+const char* GetArmInstructionName(IR::LocationDescriptor location, MemoryRead32FuncType memory_read_32) {
+    const u32 arm_instruction = memory_read_32(location.PC());
+
+    if (auto vfp_decoder = DecodeVFP2<ArmTranslatorVisitor>(arm_instruction)) {
+        return vfp_decoder->GetName();
+    } else if (auto decoder = DecodeArm<ArmTranslatorVisitor>(arm_instruction)) {
+        return decoder->GetName();
+    }
+    return "UDF";
+}
+
 bool ArmTranslatorVisitor::ConditionPassed(Cond cond) {
     ASSERT_MSG(cond_state != ConditionalState::Break,
                "This should never happen. We requested a break but that wasn't honored.");
@@ -110,8 +121,16 @@ bool ArmTranslatorVisitor::ConditionPassed(Cond cond) {
 }
 
 bool ArmTranslatorVisitor::InterpretThisInstruction() {
-    ir.SetTerm(IR::Term::Interpret(ir.current_location));
-    return false;
+    if (cond_state != ConditionalState::None) {
+        // The interpreter evaluates the condition itself, which conflicts with the block condition.
+        ir.SetTerm(IR::Term::Interpret(ir.current_location));
+        return false;
+    }
+
+    // Interpret this instruction in-line and continue with the rest of the block.
+    // If the interpreter does not continue at the next instruction, the block is exited early.
+    ir.InterpretInstruction(4);
+    return true;
 }
 
 bool ArmTranslatorVisitor::UnpredictableInstruction() {
@@ -119,6 +138,14 @@ bool ArmTranslatorVisitor::UnpredictableInstruction() {
     return false;
 }
 
+void ArmTranslatorVisitor::EmitExceptionReturn(IR::Value new_pc, IR::Value new_cpsr) {
+    // The new instruction set state is determined by the T bit of the restored CPSR.
+    // We let BXWritePC perform the alignment of the new PC appropriate to this state.
+    auto new_t_flag = ir.And(ir.LogicalShiftRight(new_cpsr, ir.Imm8(5), ir.Imm1(0)).result, ir.Imm32(1));
+    ir.BXWritePC(ir.Or(ir.And(new_pc, ir.Imm32(0xFFFFFFFE)), new_t_flag));
+    ir.SetCpsrWithModeSwitch(new_cpsr);
+}
+
 IR::IREmitter::ResultAndCarry ArmTranslatorVisitor::EmitImmShift(IR::Value value, ShiftType type, Imm5 imm5, IR::Value carry_in) {
     switch (type) {
     case ShiftType::LSL:
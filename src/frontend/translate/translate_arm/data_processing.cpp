@@ -16,9 +16,14 @@ bool ArmTranslatorVisitor::arm_ADC_imm(Cond cond, bool S, Reg n, Reg d, int rota
         auto result = ir.AddWithCarry(ir.GetRegister(n), ir.Imm32(imm32), ir.GetCFlag());
 
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
 
@@ -38,9 +43,14 @@ bool ArmTranslatorVisitor::arm_ADC_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, ir.GetCFlag());
         auto result = ir.AddWithCarry(ir.GetRegister(n), shifted.result, ir.GetCFlag());
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -78,9 +88,14 @@ bool ArmTranslatorVisitor::arm_ADD_imm(Cond cond, bool S, Reg n, Reg d, int rota
         u32 imm32 = ArmExpandImm(rotate, imm8);
         auto result = ir.AddWithCarry(ir.GetRegister(n), ir.Imm32(imm32), ir.Imm1(0));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -99,9 +114,14 @@ bool ArmTranslatorVisitor::arm_ADD_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, ir.GetCFlag());
         auto result = ir.AddWithCarry(ir.GetRegister(n), shifted.result, ir.Imm1(0));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -139,9 +159,14 @@ bool ArmTranslatorVisitor::arm_AND_imm(Cond cond, bool S, Reg n, Reg d, int rota
         auto imm_carry = ArmExpandImm_C(rotate, imm8, ir.GetCFlag());
         auto result = ir.And(ir.GetRegister(n), ir.Imm32(imm_carry.imm32));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -160,9 +185,14 @@ bool ArmTranslatorVisitor::arm_AND_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, carry_in);
         auto result = ir.And(ir.GetRegister(n), shifted.result);
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -198,9 +228,14 @@ bool ArmTranslatorVisitor::arm_BIC_imm(Cond cond, bool S, Reg n, Reg d, int rota
         auto imm_carry = ArmExpandImm_C(rotate, imm8, ir.GetCFlag());
         auto result = ir.And(ir.GetRegister(n), ir.Not(ir.Imm32(imm_carry.imm32)));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -219,9 +254,14 @@ bool ArmTranslatorVisitor::arm_BIC_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, carry_in);
         auto result = ir.And(ir.GetRegister(n), ir.Not(shifted.result));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -338,9 +378,14 @@ bool ArmTranslatorVisitor::arm_EOR_imm(Cond cond, bool S, Reg n, Reg d, int rota
         auto imm_carry = ArmExpandImm_C(rotate, imm8, ir.GetCFlag());
         auto result = ir.Eor(ir.GetRegister(n), ir.Imm32(imm_carry.imm32));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -359,9 +404,14 @@ bool ArmTranslatorVisitor::arm_EOR_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, carry_in);
         auto result = ir.Eor(ir.GetRegister(n), shifted.result);
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -397,9 +447,14 @@ bool ArmTranslatorVisitor::arm_MOV_imm(Cond cond, bool S, Reg d, int rotate, Imm
         auto imm_carry = ArmExpandImm_C(rotate, imm8, ir.GetCFlag());
         auto result = ir.Imm32(imm_carry.imm32);
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -418,9 +473,14 @@ bool ArmTranslatorVisitor::arm_MOV_reg(Cond cond, bool S, Reg d, Imm5 imm5, Shif
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, carry_in);
         auto result = shifted.result;
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -456,9 +516,14 @@ bool ArmTranslatorVisitor::arm_MVN_imm(Cond cond, bool S, Reg d, int rotate, Imm
         auto imm_carry = ArmExpandImm_C(rotate, imm8, ir.GetCFlag());
         auto result = ir.Not(ir.Imm32(imm_carry.imm32));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -477,9 +542,14 @@ bool ArmTranslatorVisitor::arm_MVN_reg(Cond cond, bool S, Reg d, Imm5 imm5, Shif
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, carry_in);
         auto result = ir.Not(shifted.result);
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -515,9 +585,14 @@ bool ArmTranslatorVisitor::arm_ORR_imm(Cond cond, bool S, Reg n, Reg d, int rota
         auto imm_carry = ArmExpandImm_C(rotate, imm8, ir.GetCFlag());
         auto result = ir.Or(ir.GetRegister(n), ir.Imm32(imm_carry.imm32));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -536,9 +611,14 @@ bool ArmTranslatorVisitor::arm_ORR_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, carry_in);
         auto result = ir.Or(ir.GetRegister(n), shifted.result);
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result);
@@ -574,9 +654,14 @@ bool ArmTranslatorVisitor::arm_RSB_imm(Cond cond, bool S, Reg n, Reg d, int rota
         u32 imm32 = ArmExpandImm(rotate, imm8);
         auto result = ir.SubWithCarry(ir.Imm32(imm32), ir.GetRegister(n), ir.Imm1(1));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -595,9 +680,14 @@ bool ArmTranslatorVisitor::arm_RSB_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, ir.GetCFlag());
         auto result = ir.SubWithCarry(shifted.result, ir.GetRegister(n), ir.Imm1(1));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -635,9 +725,14 @@ bool ArmTranslatorVisitor::arm_RSC_imm(Cond cond, bool S, Reg n, Reg d, int rota
         u32 imm32 = ArmExpandImm(rotate, imm8);
         auto result = ir.SubWithCarry(ir.Imm32(imm32), ir.GetRegister(n), ir.GetCFlag());
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -656,9 +751,14 @@ bool ArmTranslatorVisitor::arm_RSC_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, ir.GetCFlag());
         auto result = ir.SubWithCarry(shifted.result, ir.GetRegister(n), ir.GetCFlag());
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -696,9 +796,14 @@ bool ArmTranslatorVisitor::arm_SBC_imm(Cond cond, bool S, Reg n, Reg d, int rota
         u32 imm32 = ArmExpandImm(rotate, imm8);
         auto result = ir.SubWithCarry(ir.GetRegister(n), ir.Imm32(imm32), ir.GetCFlag());
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -717,9 +822,14 @@ bool ArmTranslatorVisitor::arm_SBC_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, ir.GetCFlag());
         auto result = ir.SubWithCarry(ir.GetRegister(n), shifted.result, ir.GetCFlag());
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -757,9 +867,14 @@ bool ArmTranslatorVisitor::arm_SUB_imm(Cond cond, bool S, Reg n, Reg d, int rota
         u32 imm32 = ArmExpandImm(rotate, imm8);
         auto result = ir.SubWithCarry(ir.GetRegister(n), ir.Imm32(imm32), ir.Imm1(1));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
@@ -778,9 +893,14 @@ bool ArmTranslatorVisitor::arm_SUB_reg(Cond cond, bool S, Reg n, Reg d, Imm5 imm
         auto shifted = EmitImmShift(ir.GetRegister(m), shift, imm5, ir.GetCFlag());
         auto result = ir.SubWithCarry(ir.GetRegister(n), shifted.result, ir.Imm1(1));
         if (d == Reg::PC) {
-            ASSERT(!S);
+            if (S) {
+                // This is an exception return
+                EmitExceptionReturn(result.result, ir.GetSpsr());
+                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                return false;
+            }
             ir.ALUWritePC(result.result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
         ir.SetRegister(d, result.result);
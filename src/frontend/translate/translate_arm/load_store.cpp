@@ -78,7 +78,7 @@ bool ArmTranslatorVisitor::arm_LDR_lit(Cond cond, bool U, Reg t, Imm12 imm12) {
 
         if (t == Reg::PC) {
             ir.BXWritePC(data);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
 
@@ -103,7 +103,7 @@ bool ArmTranslatorVisitor::arm_LDR_imm(Cond cond, bool P, bool U, bool W, Reg n,
             if (!P && W && n == Reg::R13)
                 ir.SetTerm(IR::Term::PopRSBHint{});
             else
-                ir.SetTerm(IR::Term::ReturnToDispatch{});
+                ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
 
@@ -126,7 +126,7 @@ bool ArmTranslatorVisitor::arm_LDR_reg(Cond cond, bool P, bool U, bool W, Reg n,
 
         if (t == Reg::PC) {
             ir.BXWritePC(data);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         }
 
@@ -697,17 +697,13 @@ bool ArmTranslatorVisitor::arm_STRH_reg(Cond cond, bool P, bool U, bool W, Reg n
 }
 
 static bool LDMHelper(IR::IREmitter& ir, bool W, Reg n, RegList list, IR::Value start_address, IR::Value writeback_address) {
-    auto address = start_address;
-    for (size_t i = 0; i <= 14; i++) {
-        if (Common::Bit(i, list)) {
-            ir.SetRegister(static_cast<Reg>(i), ir.ReadMemory32(address));
-            address = ir.Add(address, ir.Imm32(4));
-        }
-    }
+    const RegList list_without_pc = list & 0x7FFF;
+    ir.ReadMemoryToRegisters(start_address, list_without_pc);
     if (W && !Common::Bit(RegNumber(n), list)) {
         ir.SetRegister(n, writeback_address);
     }
     if (Common::Bit<15>(list)) {
+        auto address = ir.Add(start_address, ir.Imm32(u32(4 * Common::BitCount(list_without_pc))));
         ir.LoadWritePC(ir.ReadMemory32(address));
         if (n == Reg::R13)
             ir.SetTerm(IR::Term::PopRSBHint{});
@@ -766,26 +762,78 @@ bool ArmTranslatorVisitor::arm_LDMIB(Cond cond, bool W, Reg n, RegList list) {
     return true;
 }
 
-bool ArmTranslatorVisitor::arm_LDM_usr() {
-    return InterpretThisInstruction();
+static IR::Value LDMSTMStartAddress(IR::IREmitter& ir, bool P, bool U, IR::Value base, RegList list) {
+    const u32 size = u32(4 * Common::BitCount(list));
+    if (U)
+        return P ? ir.Add(base, ir.Imm32(4)) : base;
+    return P ? ir.Sub(base, ir.Imm32(size)) : ir.Sub(base, ir.Imm32(size - 4));
 }
 
-bool ArmTranslatorVisitor::arm_LDM_eret() {
-    return InterpretThisInstruction();
+static IR::Value LDMSTMWritebackAddress(IR::IREmitter& ir, bool U, IR::Value base, RegList list) {
+    const u32 size = u32(4 * Common::BitCount(list));
+    return U ? ir.Add(base, ir.Imm32(size)) : ir.Sub(base, ir.Imm32(size));
 }
 
-static bool STMHelper(IR::IREmitter& ir, bool W, Reg n, RegList list, IR::Value start_address, IR::Value writeback_address) {
-    auto address = start_address;
-    for (size_t i = 0; i <= 14; i++) {
-        if (Common::Bit(i, list)) {
-            ir.WriteMemory32(address, ir.GetRegister(static_cast<Reg>(i)));
-            address = ir.Add(address, ir.Imm32(4));
+static IR::Value SwitchToSystemMode(IR::IREmitter& ir) {
+    // User mode registers are accessed by temporarily switching to System mode, which shares them.
+    // This has no effect when executed in User mode, where these instructions are UNPREDICTABLE.
+    auto old_cpsr = ir.GetCpsr();
+    ir.SetCpsrWithModeSwitch(ir.Or(old_cpsr, ir.Imm32(0x1F)));
+    return old_cpsr;
+}
+
+bool ArmTranslatorVisitor::arm_LDM_usr(Cond cond, bool P, bool U, Reg n, RegList list) {
+    if (n == Reg::PC || Common::BitCount(list) < 1)
+        return UnpredictableInstruction();
+    // LDM{<amode>} <Rn>, <reg_list_without_pc>^
+    if (ConditionPassed(cond)) {
+        auto address = LDMSTMStartAddress(ir, P, U, ir.GetRegister(n), list);
+        auto old_cpsr = SwitchToSystemMode(ir);
+        for (size_t i = 0; i <= 14; i++) {
+            if (Common::Bit(i, list)) {
+                ir.SetRegister(static_cast<Reg>(i), ir.ReadMemory32(address));
+                address = ir.Add(address, ir.Imm32(4));
+            }
         }
+        ir.SetCpsrWithModeSwitch(old_cpsr);
     }
+    return true;
+}
+
+bool ArmTranslatorVisitor::arm_LDM_eret(Cond cond, bool P, bool U, bool W, Reg n, RegList list) {
+    if (n == Reg::PC)
+        return UnpredictableInstruction();
+    if (W && Common::Bit(RegNumber(n), list))
+        return UnpredictableInstruction();
+    // LDM{<amode>} <Rn>{!}, <reg_list_with_pc>^
+    if (ConditionPassed(cond)) {
+        auto base = ir.GetRegister(n);
+        auto address = LDMSTMStartAddress(ir, P, U, base, list);
+        for (size_t i = 0; i <= 14; i++) {
+            if (Common::Bit(i, list)) {
+                ir.SetRegister(static_cast<Reg>(i), ir.ReadMemory32(address));
+                address = ir.Add(address, ir.Imm32(4));
+            }
+        }
+        if (W) {
+            ir.SetRegister(n, LDMSTMWritebackAddress(ir, U, base, list));
+        }
+        auto new_pc = ir.ReadMemory32(address);
+        EmitExceptionReturn(new_pc, ir.GetSpsr());
+        ir.SetTerm(IR::Term::ReturnToDispatch{});
+        return false;
+    }
+    return true;
+}
+
+static bool STMHelper(IR::IREmitter& ir, bool W, Reg n, RegList list, IR::Value start_address, IR::Value writeback_address) {
+    const RegList list_without_pc = list & 0x7FFF;
+    ir.WriteMemoryFromRegisters(start_address, list_without_pc);
     if (W) {
         ir.SetRegister(n, writeback_address);
     }
     if (Common::Bit<15>(list)) {
+        auto address = ir.Add(start_address, ir.Imm32(u32(4 * Common::BitCount(list_without_pc))));
         ir.WriteMemory32(address, ir.Imm32(ir.PC()));
     }
     return true;
@@ -839,8 +887,25 @@ bool ArmTranslatorVisitor::arm_STMIB(Cond cond, bool W, Reg n, RegList list) {
     return true;
 }
 
-bool ArmTranslatorVisitor::arm_STM_usr() {
-    return InterpretThisInstruction();
+bool ArmTranslatorVisitor::arm_STM_usr(Cond cond, bool P, bool U, Reg n, RegList list) {
+    if (n == Reg::PC || Common::BitCount(list) < 1)
+        return UnpredictableInstruction();
+    // STM{<amode>} <Rn>, <reg_list>^
+    if (ConditionPassed(cond)) {
+        auto address = LDMSTMStartAddress(ir, P, U, ir.GetRegister(n), list);
+        auto old_cpsr = SwitchToSystemMode(ir);
+        for (size_t i = 0; i <= 14; i++) {
+            if (Common::Bit(i, list)) {
+                ir.WriteMemory32(address, ir.GetRegister(static_cast<Reg>(i)));
+                address = ir.Add(address, ir.Imm32(4));
+            }
+        }
+        if (Common::Bit<15>(list)) {
+            ir.WriteMemory32(address, ir.Imm32(ir.PC()));
+        }
+        ir.SetCpsrWithModeSwitch(old_cpsr);
+    }
+    return true;
 }
 
 } // namespace Arm
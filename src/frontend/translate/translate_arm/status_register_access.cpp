@@ -9,62 +9,140 @@
 namespace Dynarmic {
 namespace Arm {
 
-bool ArmTranslatorVisitor::arm_CPS() {
-    return InterpretThisInstruction();
+static u32 MSRFieldMask(int mask) {
+    u32 field_mask = 0;
+    if (Common::Bit<3>(mask))
+        field_mask |= 0xFF000000;
+    if (Common::Bit<2>(mask))
+        field_mask |= 0x00FF0000;
+    if (Common::Bit<1>(mask))
+        field_mask |= 0x0000FF00;
+    if (Common::Bit<0>(mask))
+        field_mask |= 0x000000FF;
+    return field_mask;
 }
 
-bool ArmTranslatorVisitor::arm_MRS(Cond cond, Reg d) {
+static bool MSRHelper(IR::IREmitter& ir, bool R, int mask, IR::Value value) {
+    if (R) {
+        // MSR SPSR_<fields>, <value>
+        u32 spsr_mask = MSRFieldMask(mask);
+        auto old_spsr = ir.And(ir.GetSpsr(), ir.Imm32(~spsr_mask));
+        auto new_spsr = ir.And(value, ir.Imm32(spsr_mask));
+        ir.SetSpsr(ir.Or(old_spsr, new_spsr));
+        return true;
+    }
+
+    // MSR CPSR_<fields>, <value>
+    // The T bit and the J bit cannot be written by MSR.
+    u32 cpsr_mask = MSRFieldMask(mask) & 0xF80F03DF;
+    auto old_cpsr = ir.And(ir.GetCpsr(), ir.Imm32(~cpsr_mask));
+    auto new_cpsr = ir.Or(old_cpsr, ir.And(value, ir.Imm32(cpsr_mask)));
+
+    const bool write_privileged = (cpsr_mask & 0x0000FFFF) != 0;
+    if (!write_privileged) {
+        // Writes to only the APSR do not affect the processor mode.
+        ir.SetCpsr(new_cpsr);
+        return true;
+    }
+
+    ir.SetCpsrWithModeSwitch(new_cpsr);
+
+    const bool write_e = Common::Bit<1>(mask);
+    if (write_e) {
+        // The E bit is part of the location descriptor; return to the dispatcher.
+        ir.BranchWritePC(ir.Imm32(ir.current_location.PC() + 4));
+        ir.SetTerm(IR::Term::ReturnToDispatch{});
+        return false;
+    }
+    return true;
+}
+
+static IR::Value RFESRSAddress(IR::IREmitter& ir, bool P, bool U, IR::Value base) {
+    const bool wordhigher = P == U;
+    u32 offset = U ? 0 : 0xFFFFFFF8;
+    if (wordhigher)
+        offset += 4;
+    return ir.Add(base, ir.Imm32(offset));
+}
+
+static IR::Value RFESRSWritebackAddress(IR::IREmitter& ir, bool U, IR::Value base) {
+    return U ? ir.Add(base, ir.Imm32(8)) : ir.Sub(base, ir.Imm32(8));
+}
+
+bool ArmTranslatorVisitor::arm_CPS(int imod, bool M, bool A, bool I, bool F, Imm5 mode) {
+    if (imod == 0b01 || (imod == 0b00 && !M) || (!M && mode != 0))
+        return UnpredictableInstruction();
+    // CPS<effect> <iflags>{, #<mode>}
+    // CPS #<mode>
+    // This instruction has no effect in User mode; this is handled by SetCpsrWithModeSwitch.
+    u32 aif_mask = 0;
+    if (A)
+        aif_mask |= 0x100;
+    if (I)
+        aif_mask |= 0x080;
+    if (F)
+        aif_mask |= 0x040;
+
+    auto cpsr = ir.GetCpsr();
+    if (imod == 0b10)
+        cpsr = ir.And(cpsr, ir.Imm32(~aif_mask));
+    if (imod == 0b11)
+        cpsr = ir.Or(cpsr, ir.Imm32(aif_mask));
+    if (M)
+        cpsr = ir.Or(ir.And(cpsr, ir.Imm32(~0x1Fu)), ir.Imm32(mode));
+    ir.SetCpsrWithModeSwitch(cpsr);
+    return true;
+}
+
+bool ArmTranslatorVisitor::arm_MRS(Cond cond, bool R, Reg d) {
     if (d == Reg::PC)
         return UnpredictableInstruction();
     // MRS <Rd>, APSR
+    // MRS <Rd>, SPSR
     if (ConditionPassed(cond)) {
-        ir.SetRegister(d, ir.GetCpsr());
+        ir.SetRegister(d, R ? ir.GetSpsr() : ir.GetCpsr());
     }
     return true;
 }
 
-bool ArmTranslatorVisitor::arm_MSR_imm(Cond cond, int mask, int rotate, Imm8 imm8) {
-    bool write_nzcvq = Common::Bit<1>(mask);
-    bool write_g = Common::Bit<0>(mask);
+bool ArmTranslatorVisitor::arm_MSR_imm(Cond cond, bool R, int mask, int rotate, Imm8 imm8) {
     u32 imm32 = ArmExpandImm(rotate, imm8);
-    ASSERT_MSG(write_nzcvq || write_g, "Decode error");
+    ASSERT_MSG(R || mask != 0, "Decode error");
+    if (mask == 0)
+        return UnpredictableInstruction();
     // MSR <spec_reg>, #<imm32>
     if (ConditionPassed(cond)) {
-        u32 cpsr_mask = 0;
-        if (write_nzcvq)
-            cpsr_mask |= 0xF8000000;
-        if (write_g)
-            cpsr_mask |= 0x000F0000;
-        auto old_cpsr = ir.And(ir.GetCpsr(), ir.Imm32(~cpsr_mask));
-        auto new_cpsr = ir.Imm32(imm32 & cpsr_mask);
-        ir.SetCpsr(ir.Or(old_cpsr, new_cpsr));
+        return MSRHelper(ir, R, mask, ir.Imm32(imm32));
     }
     return true;
 }
 
-bool ArmTranslatorVisitor::arm_MSR_reg(Cond cond, int mask, Reg n) {
-    bool write_nzcvq = Common::Bit<1>(mask);
-    bool write_g = Common::Bit<0>(mask);
-    if (!write_nzcvq && !write_g)
+bool ArmTranslatorVisitor::arm_MSR_reg(Cond cond, bool R, int mask, Reg n) {
+    if (mask == 0)
         return UnpredictableInstruction();
     if (n == Reg::PC)
         return UnpredictableInstruction();
-    // MSR <spec_reg>, #<imm32>
+    // MSR <spec_reg>, <Rn>
     if (ConditionPassed(cond)) {
-        u32 cpsr_mask = 0;
-        if (write_nzcvq)
-            cpsr_mask |= 0xF8000000;
-        if (write_g)
-            cpsr_mask |= 0x000F0000;
-        auto old_cpsr = ir.And(ir.GetCpsr(), ir.Imm32(~cpsr_mask));
-        auto new_cpsr = ir.And(ir.GetRegister(n), ir.Imm32(cpsr_mask));
-        ir.SetCpsr(ir.Or(old_cpsr, new_cpsr));
+        return MSRHelper(ir, R, mask, ir.GetRegister(n));
     }
     return true;
 }
 
-bool ArmTranslatorVisitor::arm_RFE() {
-    return InterpretThisInstruction();
+bool ArmTranslatorVisitor::arm_RFE(bool P, bool U, bool W, Reg n) {
+    if (n == Reg::PC)
+        return UnpredictableInstruction();
+    // RFE{<amode>} <Rn>{!}
+    auto base = ir.GetRegister(n);
+    auto address = RFESRSAddress(ir, P, U, base);
+    auto new_pc = ir.ReadMemory32(address);
+    auto new_cpsr = ir.ReadMemory32(ir.Add(address, ir.Imm32(4)));
+    if (W) {
+        ir.SetRegister(n, RFESRSWritebackAddress(ir, U, base));
+    }
+    EmitExceptionReturn(new_pc, new_cpsr);
+    ir.SetTerm(IR::Term::ReturnToDispatch{});
+    return false;
 }
 
 bool ArmTranslatorVisitor::arm_SETEND(bool E) {
@@ -73,8 +151,24 @@ bool ArmTranslatorVisitor::arm_SETEND(bool E) {
     return false;
 }
 
-bool ArmTranslatorVisitor::arm_SRS() {
-    return InterpretThisInstruction();
+bool ArmTranslatorVisitor::arm_SRS(bool P, bool U, bool W, Imm5 mode) {
+    // SRS{<amode>} SP{!}, #<mode>
+    // We temporarily switch to the target mode to access its banked SP.
+    auto lr = ir.GetRegister(Reg::LR);
+    auto spsr = ir.GetSpsr();
+    auto old_cpsr = ir.GetCpsr();
+    ir.SetCpsrWithModeSwitch(ir.Or(ir.And(old_cpsr, ir.Imm32(~0x1Fu)), ir.Imm32(mode)));
+
+    auto base = ir.GetRegister(Reg::SP);
+    auto address = RFESRSAddress(ir, P, U, base);
+    ir.WriteMemory32(address, lr);
+    ir.WriteMemory32(ir.Add(address, ir.Imm32(4)), spsr);
+    if (W) {
+        ir.SetRegister(Reg::SP, RFESRSWritebackAddress(ir, U, base));
+    }
+
+    ir.SetCpsrWithModeSwitch(old_cpsr);
+    return true;
 }
 
 bool ArmTranslatorVisitor::arm_SEL(Cond cond, Reg n, Reg d, Reg m) {
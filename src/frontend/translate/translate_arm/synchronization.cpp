@@ -135,8 +135,7 @@ bool ArmTranslatorVisitor::arm_SWP(Cond cond, Reg n, Reg t, Reg t2) {
     // TODO: UNDEFINED if current mode is Hypervisor
     // SWP <Rt>, <Rt2>, [<Rn>]
     if (ConditionPassed(cond)) {
-        auto data = ir.ReadMemory32(ir.GetRegister(n));
-        ir.WriteMemory32(ir.GetRegister(n), ir.GetRegister(t2));
+        auto data = ir.SwapMemory32(ir.GetRegister(n), ir.GetRegister(t2));
         // TODO: Alignment check
         ir.SetRegister(t, data);
     }
@@ -149,8 +148,7 @@ bool ArmTranslatorVisitor::arm_SWPB(Cond cond, Reg n, Reg t, Reg t2) {
     // TODO: UNDEFINED if current mode is Hypervisor
     // SWPB <Rt>, <Rt2>, [<Rn>]
     if (ConditionPassed(cond)) {
-        auto data = ir.ReadMemory8(ir.GetRegister(n));
-        ir.WriteMemory8(ir.GetRegister(n), ir.LeastSignificantByte(ir.GetRegister(t2)));
+        auto data = ir.SwapMemory8(ir.GetRegister(n), ir.LeastSignificantByte(ir.GetRegister(t2)));
         // TODO: Alignment check
         ir.SetRegister(t, ir.ZeroExtendByteToWord(data));
     }
@@ -26,7 +26,7 @@ enum class ConditionalState {
 struct ArmTranslatorVisitor final {
     using instruction_return_type = bool;
 
-    explicit ArmTranslatorVisitor(IR::LocationDescriptor descriptor) : ir(descriptor) {
+    explicit ArmTranslatorVisitor(IR::LocationDescriptor descriptor, Common::Pool* instruction_pool) : ir(descriptor, instruction_pool) {
         ASSERT_MSG(!descriptor.TFlag(), "The processor must be in Arm mode");
     }
 
@@ -65,6 +65,7 @@ struct ArmTranslatorVisitor final {
     IR::IREmitter::ResultAndCarry EmitImmShift(IR::Value value, ShiftType type, Imm5 imm5, IR::Value carry_in);
     IR::IREmitter::ResultAndCarry EmitRegShift(IR::Value value, ShiftType type, IR::Value amount, IR::Value carry_in);
     IR::Value SignZeroExtendRor(Reg m, SignExtendRotation rotate);
+    void EmitExceptionReturn(IR::Value new_pc, IR::Value new_cpsr);
 
     // Branch instructions
     bool arm_B(Cond cond, Imm24 imm24);
@@ -200,13 +201,13 @@ struct ArmTranslatorVisitor final {
     bool arm_LDMDA(Cond cond, bool W, Reg n, RegList list);
     bool arm_LDMDB(Cond cond, bool W, Reg n, RegList list);
     bool arm_LDMIB(Cond cond, bool W, Reg n, RegList list);
-    bool arm_LDM_usr();
-    bool arm_LDM_eret();
+    bool arm_LDM_usr(Cond cond, bool P, bool U, Reg n, RegList list);
+    bool arm_LDM_eret(Cond cond, bool P, bool U, bool W, Reg n, RegList list);
     bool arm_STM(Cond cond, bool W, Reg n, RegList list);
     bool arm_STMDA(Cond cond, bool W, Reg n, RegList list);
     bool arm_STMDB(Cond cond, bool W, Reg n, RegList list);
     bool arm_STMIB(Cond cond, bool W, Reg n, RegList list);
-    bool arm_STM_usr();
+    bool arm_STM_usr(Cond cond, bool P, bool U, Reg n, RegList list);
 
     // Miscellaneous instructions
     bool arm_CLZ(Cond cond, Reg d, Reg m);
@@ -345,13 +346,13 @@ struct ArmTranslatorVisitor final {
     bool arm_SWPB(Cond cond, Reg n, Reg d, Reg m);
 
     // Status register access instructions
-    bool arm_CPS();
-    bool arm_MRS(Cond cond, Reg d);
-    bool arm_MSR_imm(Cond cond, int mask, int rotate, Imm8 imm8);
-    bool arm_MSR_reg(Cond cond, int mask, Reg n);
-    bool arm_RFE();
+    bool arm_CPS(int imod, bool M, bool A, bool I, bool F, Imm5 mode);
+    bool arm_MRS(Cond cond, bool R, Reg d);
+    bool arm_MSR_imm(Cond cond, bool R, int mask, int rotate, Imm8 imm8);
+    bool arm_MSR_reg(Cond cond, bool R, int mask, Reg n);
+    bool arm_RFE(bool P, bool U, bool W, Reg n);
     bool arm_SETEND(bool E);
-    bool arm_SRS();
+    bool arm_SRS(bool P, bool U, bool W, Imm5 mode);
 
     // Floating-point three-register data processing instructions
     bool vfp2_VADD(Cond cond, bool D, size_t Vn, size_t Vd, bool sz, bool N, bool M, size_t Vm);
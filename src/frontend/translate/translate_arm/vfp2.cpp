@@ -468,10 +468,11 @@ bool ArmTranslatorVisitor::vfp2_VMSR(Cond cond, Reg t) {
 
     // VMSR FPSCR, <Rt>
     if (ConditionPassed(cond)) {
-        ir.PushRSB(ir.current_location.AdvancePC(4)); // TODO: Replace this with a local cache.
         ir.SetFpscr(ir.GetRegister(t));
         ir.BranchWritePC(ir.Imm32(ir.current_location.PC() + 4));
-        ir.SetTerm(IR::Term::PopRSBHint{});
+        // The FPSCR mode bits may have changed, so the next block's location descriptor is only
+        // known at run-time.
+        ir.SetTerm(IR::Term::IndirectBranchHint{});
         return false;
     }
     return true;
@@ -504,23 +505,8 @@ bool ArmTranslatorVisitor::vfp2_VPOP(Cond cond, bool D, size_t Vd, bool sz, Imm8
     // VPOP.{F32,F64} <list>
     if (ConditionPassed(cond)) {
         auto address = ir.GetRegister(Reg::SP);
-
-        for (size_t i = 0; i < regs; ++i) {
-            if (sz) {
-                auto lo = ir.ReadMemory32(address);
-                address = ir.Add(address, ir.Imm32(4));
-                auto hi = ir.ReadMemory32(address);
-                address = ir.Add(address, ir.Imm32(4));
-                if (ir.current_location.EFlag()) std::swap(lo, hi);
-                ir.SetExtendedRegister(d + i, ir.TransferToFP64(ir.Pack2x32To1x64(lo, hi)));
-            } else {
-                auto res = ir.ReadMemory32(address);
-                ir.SetExtendedRegister(d + i, ir.TransferToFP32(res));
-                address = ir.Add(address, ir.Imm32(4));
-            }
-        }
-
-        ir.SetRegister(Reg::SP, address);
+        ir.ReadMemoryToExtendedRegisters(address, d, regs);
+        ir.SetRegister(Reg::SP, ir.Add(address, ir.Imm32(u32(regs * (sz ? 8 : 4)))));
     }
     return true;
 }
@@ -539,22 +525,7 @@ bool ArmTranslatorVisitor::vfp2_VPUSH(Cond cond, bool D, size_t Vd, bool sz, Imm
     if (ConditionPassed(cond)) {
         auto address = ir.Sub(ir.GetRegister(Reg::SP), ir.Imm32(imm32));
         ir.SetRegister(Reg::SP, address);
-
-        for (size_t i = 0; i < regs; ++i) {
-            if (sz) {
-                const auto d_u64 = ir.TransferFromFP64(ir.GetExtendedRegister(d + i));
-                auto lo = ir.LeastSignificantWord(d_u64);
-                auto hi = ir.MostSignificantWord(d_u64).result;
-                if (ir.current_location.EFlag()) std::swap(lo, hi);
-                ir.WriteMemory32(address, lo);
-                address = ir.Add(address, ir.Imm32(4));
-                ir.WriteMemory32(address, hi);
-                address = ir.Add(address, ir.Imm32(4));
-            } else {
-                ir.WriteMemory32(address, ir.TransferFromFP32(ir.GetExtendedRegister(d + i)));
-                address = ir.Add(address, ir.Imm32(4));
-            }
-        }
+        ir.WriteMemoryFromExtendedRegisters(address, d, regs);
     }
     return true;
 }
@@ -621,16 +592,7 @@ bool ArmTranslatorVisitor::vfp2_VSTM_a1(Cond cond, bool p, bool u, bool D, bool
         auto address = u ? ir.GetRegister(n) : ir.Sub(ir.GetRegister(n), ir.Imm32(imm32));
         if (w)
             ir.SetRegister(n, u ? ir.Add(address, ir.Imm32(imm32)) : address);
-        for (size_t i = 0; i < regs; i++) {
-            auto value = ir.TransferFromFP64(ir.GetExtendedRegister(d + i));
-            auto word1 = ir.LeastSignificantWord(value);
-            auto word2 = ir.MostSignificantWord(value).result;
-            if (ir.current_location.EFlag()) std::swap(word1, word2);
-            ir.WriteMemory32(address, word1);
-            address = ir.Add(address, ir.Imm32(4));
-            ir.WriteMemory32(address, word2);
-            address = ir.Add(address, ir.Imm32(4));
-        }
+        ir.WriteMemoryFromExtendedRegisters(address, d, regs);
     }
     return true;
 }
@@ -657,11 +619,7 @@ bool ArmTranslatorVisitor::vfp2_VSTM_a2(Cond cond, bool p, bool u, bool D, bool
         auto address = u ? ir.GetRegister(n) : ir.Sub(ir.GetRegister(n), ir.Imm32(imm32));
         if (w)
             ir.SetRegister(n, u ? ir.Add(address, ir.Imm32(imm32)) : address);
-        for (size_t i = 0; i < regs; i++) {
-            auto word = ir.TransferFromFP32(ir.GetExtendedRegister(d + i));
-            ir.WriteMemory32(address, word);
-            address = ir.Add(address, ir.Imm32(4));
-        }
+        ir.WriteMemoryFromExtendedRegisters(address, d, regs);
     }
     return true;
 }
@@ -688,14 +646,7 @@ bool ArmTranslatorVisitor::vfp2_VLDM_a1(Cond cond, bool p, bool u, bool D, bool
         auto address = u ? ir.GetRegister(n) : ir.Sub(ir.GetRegister(n), ir.Imm32(imm32));
         if (w)
             ir.SetRegister(n, u ? ir.Add(address, ir.Imm32(imm32)) : address);
-        for (size_t i = 0; i < regs; i++) {
-            auto word1 = ir.ReadMemory32(address);
-            address = ir.Add(address, ir.Imm32(4));
-            auto word2 = ir.ReadMemory32(address);
-            address = ir.Add(address, ir.Imm32(4));
-            if (ir.current_location.EFlag()) std::swap(word1, word2);
-            ir.SetExtendedRegister(d + i, ir.TransferToFP64(ir.Pack2x32To1x64(word1, word2)));
-        }
+        ir.ReadMemoryToExtendedRegisters(address, d, regs);
     }
     return true;
 }
@@ -722,11 +673,7 @@ bool ArmTranslatorVisitor::vfp2_VLDM_a2(Cond cond, bool p, bool u, bool D, bool
         auto address = u ? ir.GetRegister(n) : ir.Sub(ir.GetRegister(n), ir.Imm32(imm32));
         if (w)
             ir.SetRegister(n, u ? ir.Add(address, ir.Imm32(imm32)) : address);
-        for (size_t i = 0; i < regs; i++) {
-            auto word = ir.ReadMemory32(address);
-            address = ir.Add(address, ir.Imm32(4));
-            ir.SetExtendedRegister(d + i, ir.TransferToFP32(word));
-        }
+        ir.ReadMemoryToExtendedRegisters(address, d, regs);
     }
     return true;
 }
@@ -23,15 +23,17 @@ namespace {
 struct ThumbTranslatorVisitor final {
     using instruction_return_type = bool;
 
-    explicit ThumbTranslatorVisitor(IR::LocationDescriptor descriptor) : ir(descriptor) {
+    explicit ThumbTranslatorVisitor(IR::LocationDescriptor descriptor, Common::Pool* instruction_pool) : ir(descriptor, instruction_pool) {
         ASSERT_MSG(descriptor.TFlag(), "The processor must be in Thumb mode");
     }
 
     IR::IREmitter ir;
 
-    bool InterpretThisInstruction() {
-        ir.SetTerm(IR::Term::Interpret(ir.current_location));
-        return false;
+    bool InterpretThisInstruction(u32 instruction_size) {
+        // Interpret this instruction in-line and continue with the rest of the block.
+        // If the interpreter does not continue at the next instruction, the block is exited early.
+        ir.InterpretInstruction(instruction_size);
+        return true;
     }
 
     bool UnpredictableInstruction() {
@@ -359,8 +361,8 @@ struct ThumbTranslatorVisitor final {
         auto result = ir.AddWithCarry(ir.GetRegister(n), ir.GetRegister(m), ir.Imm1(0));
         if (d == Reg::PC) {
             ir.ALUWritePC(result.result);
-            // Return to dispatch as we can't predict what PC is going to be. Stop compilation.
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            // We can't predict what PC is going to be at translation time. Stop compilation.
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         } else {
             ir.SetRegister(d, result.result);
@@ -390,7 +392,7 @@ struct ThumbTranslatorVisitor final {
         auto result = ir.GetRegister(m);
         if (d == Reg::PC) {
             ir.ALUWritePC(result);
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
             return false;
         } else {
             ir.SetRegister(d, result);
@@ -636,15 +638,8 @@ struct ThumbTranslatorVisitor final {
         // reg_list cannot encode for R15.
         const u32 num_bytes_to_push = static_cast<u32>(4 * Common::BitCount(reg_list));
         const auto final_address = ir.Sub(ir.GetRegister(Reg::SP), ir.Imm32(num_bytes_to_push));
-        auto address = final_address;
-        for (size_t i = 0; i < 16; i++) {
-            if (Common::Bit(i, reg_list)) {
-                // TODO: Deal with alignment
-                auto Ri = ir.GetRegister(static_cast<Reg>(i));
-                ir.WriteMemory32(address, Ri);
-                address = ir.Add(address, ir.Imm32(4));
-            }
-        }
+        // TODO: Deal with alignment
+        ir.WriteMemoryFromRegisters(final_address, reg_list);
         ir.SetRegister(Reg::SP, final_address);
         // TODO(optimization): Possible location for an RSB push.
         return true;
@@ -656,15 +651,11 @@ struct ThumbTranslatorVisitor final {
             return UnpredictableInstruction();
         }
         // POP <reg_list>
+        const RegList list_without_pc = reg_list & 0x7FFF;
         auto address = ir.GetRegister(Reg::SP);
-        for (size_t i = 0; i < 15; i++) {
-            if (Common::Bit(i, reg_list)) {
-                // TODO: Deal with alignment
-                auto data = ir.ReadMemory32(address);
-                ir.SetRegister(static_cast<Reg>(i), data);
-                address = ir.Add(address, ir.Imm32(4));
-            }
-        }
+        // TODO: Deal with alignment
+        ir.ReadMemoryToRegisters(address, list_without_pc);
+        address = ir.Add(address, ir.Imm32(u32(4 * Common::BitCount(list_without_pc))));
         if (Common::Bit<15>(reg_list)) {
             // TODO(optimization): Possible location for an RSB pop.
             auto data = ir.ReadMemory32(address);
@@ -721,14 +712,8 @@ struct ThumbTranslatorVisitor final {
     bool thumb16_STMIA(Reg n, RegList reg_list) {
         // STM <Rn>!, <reg_list>
         auto address = ir.GetRegister(n);
-        for (size_t i = 0; i < 8; i++) {
-            if (Common::Bit(i, reg_list)) {
-                auto Ri = ir.GetRegister(static_cast<Reg>(i));
-                ir.WriteMemory32(address, Ri);
-                address = ir.Add(address, ir.Imm32(4));
-            }
-        }
-        ir.SetRegister(n, address);
+        ir.WriteMemoryFromRegisters(address, reg_list);
+        ir.SetRegister(n, ir.Add(address, ir.Imm32(u32(4 * Common::BitCount(reg_list)))));
         return true;
     }
 
@@ -736,21 +721,15 @@ struct ThumbTranslatorVisitor final {
         bool write_back = !Dynarmic::Common::Bit(static_cast<size_t>(n), reg_list);
         // STM <Rn>!, <reg_list>
         auto address = ir.GetRegister(n);
-        for (size_t i = 0; i < 8; i++) {
-            if (Common::Bit(i, reg_list)) {
-                auto data = ir.ReadMemory32(address);
-                ir.SetRegister(static_cast<Reg>(i), data);
-                address = ir.Add(address, ir.Imm32(4));
-            }
-        }
+        ir.ReadMemoryToRegisters(address, reg_list);
         if (write_back) {
-            ir.SetRegister(n, address);
+            ir.SetRegister(n, ir.Add(address, ir.Imm32(u32(4 * Common::BitCount(reg_list)))));
         }
         return true;
     }
 
     bool thumb16_UDF() {
-        return InterpretThisInstruction();
+        return InterpretThisInstruction(2);
     }
 
     bool thumb16_BX(Reg m) {
@@ -759,7 +738,7 @@ struct ThumbTranslatorVisitor final {
         if (m == Reg::R14)
             ir.SetTerm(IR::Term::PopRSBHint{});
         else
-            ir.SetTerm(IR::Term::ReturnToDispatch{});
+            ir.SetTerm(IR::Term::IndirectBranchHint{});
         return false;
     }
 
@@ -768,7 +747,7 @@ struct ThumbTranslatorVisitor final {
         ir.PushRSB(ir.current_location.AdvancePC(2));
         ir.BXWritePC(ir.GetRegister(m));
         ir.SetRegister(Reg::LR, ir.Imm32((ir.current_location.PC() + 2) | 1));
-        ir.SetTerm(IR::Term::ReturnToDispatch{});
+        ir.SetTerm(IR::Term::IndirectBranchHint{});
         return false;
     }
 
@@ -828,7 +807,7 @@ struct ThumbTranslatorVisitor final {
     }
 
     bool thumb32_UDF() {
-        return thumb16_UDF();
+        return InterpretThisInstruction(4);
     }
 };
 
@@ -860,8 +839,8 @@ std::tuple<u32, ThumbInstSize> ReadThumbInstruction(u32 arm_pc, MemoryRead32Func
 
 } // local namespace
 
-IR::Block TranslateThumb(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32) {
-    ThumbTranslatorVisitor visitor{descriptor};
+IR::Block TranslateThumb(IR::LocationDescriptor descriptor, MemoryRead32FuncType memory_read_32, Common::Pool* instruction_pool) {
+    ThumbTranslatorVisitor visitor{descriptor, instruction_pool};
 
     bool should_continue = true;
     while (should_continue) {
@@ -895,5 +874,22 @@ IR::Block TranslateThumb(IR::LocationDescriptor descriptor, MemoryRead32FuncType
     return std::move(visitor.ir.block);
 }
 
+const char* GetThumbInstructionName(IR::LocationDescriptor location, MemoryRead32FuncType memory_read_32) {
+    u32 thumb_instruction;
+    ThumbInstSize inst_size;
+    std::tie(thumb_instruction, inst_size) = ReadThumbInstruction(location.PC(), memory_read_32);
+
+    if (inst_size == ThumbInstSize::Thumb16) {
+        if (auto decoder = DecodeThumb16<ThumbTranslatorVisitor>(static_cast<u16>(thumb_instruction))) {
+            return decoder->GetName();
+        }
+    } else {
+        if (auto decoder = DecodeThumb32<ThumbTranslatorVisitor>(thumb_instruction)) {
+            return decoder->GetName();
+        }
+    }
+    return "UDF";
+}
+
 } // namespace Arm
 } // namepsace Dynarmic
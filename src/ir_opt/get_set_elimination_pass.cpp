@@ -7,6 +7,7 @@
 #include <array>
 
 #include "common/assert.h"
+#include "common/bit_util.h"
 #include "common/common_types.h"
 #include "frontend/ir/basic_block.h"
 #include "frontend/ir/value.h"
@@ -155,6 +156,46 @@ void GetSetElimination(IR::Block& block) {
             do_get(cpsr_info.ge, inst);
             break;
         }
+        case IR::Opcode::ReadMemoryToRegisters:
+        case IR::Opcode::WriteMemoryFromRegisters: {
+            // These access the guest registers directly.
+            u32 list = inst->GetArg(1).GetU32();
+            for (size_t i = 0; i < reg_info.size(); i++) {
+                if (Common::Bit(i, list)) {
+                    reg_info[i] = {};
+                }
+            }
+            break;
+        }
+        case IR::Opcode::ReadMemoryToExtendedRegisters:
+        case IR::Opcode::WriteMemoryFromExtendedRegisters: {
+            // These access the guest registers directly.
+            Arm::ExtReg first = inst->GetArg(1).GetExtRegRef();
+            size_t count = inst->GetArg(2).GetU8();
+            size_t singles_begin = Arm::IsDoubleExtReg(first) ? Arm::RegNumber(first) * 2 : Arm::RegNumber(first);
+            size_t singles_end = singles_begin + (Arm::IsDoubleExtReg(first) ? count * 2 : count);
+            for (size_t i = singles_begin; i < singles_end; i++) {
+                if (i < ext_reg_singles_info.size()) {
+                    ext_reg_singles_info[i] = {};
+                }
+                ext_reg_doubles_info[i / 2] = {};
+            }
+            break;
+        }
+        case IR::Opcode::InterpretInstruction: {
+            // The interpreter may read and write any part of the guest state.
+            reg_info = {};
+            ext_reg_singles_info = {};
+            ext_reg_doubles_info = {};
+            cpsr_info = {};
+            break;
+        }
+        case IR::Opcode::SetCpsrWithModeSwitch: {
+            // The values of R8-R14 depend on the processor mode.
+            reg_info = {};
+            cpsr_info = {};
+            break;
+        }
         default: {
             if (inst->ReadsFromCPSR() || inst->WritesToCPSR()) {
                 cpsr_info = {};
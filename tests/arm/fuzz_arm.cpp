@@ -10,9 +10,12 @@
 #include <cstdio>
 #include <cstring>
 #include <functional>
+#include <string>
 #include <tuple>
 #include <vector>
 
+#include <xmmintrin.h>
+
 #include <catch.hpp>
 
 #include <dynarmic/dynarmic.h>
@@ -32,6 +35,10 @@
 #include <signal.h>
 #endif
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 using Dynarmic::Common::Bits;
 
 struct WriteRecord {
@@ -135,6 +142,39 @@ static Dynarmic::UserCallbacks GetUserCallbacks() {
     return user_callbacks;
 }
 
+constexpr u32 MAPPED_VADDR = 0x10000;
+static std::array<u8, 2 << Dynarmic::UserCallbacks::PAGE_BITS> mapped_memory;
+
+/**
+ * As GetUserCallbacks, but the first `mapped_pages` (at most two) pages at MAPPED_VADDR are mapped
+ * onto mapped_memory through UserCallbacks::page_table. Clears mapped_memory and write_records.
+ */
+static Dynarmic::UserCallbacks GetUserCallbacksWithPageTable(size_t mapped_pages = 1) {
+    static std::array<u8*, Dynarmic::UserCallbacks::NUM_PAGE_TABLE_ENTRIES> page_table;
+    page_table.fill(nullptr);
+    for (size_t i = 0; i < mapped_pages; i++) {
+        page_table[(MAPPED_VADDR >> Dynarmic::UserCallbacks::PAGE_BITS) + i] = mapped_memory.data() + (i << Dynarmic::UserCallbacks::PAGE_BITS);
+    }
+
+    mapped_memory.fill(0);
+    write_records.clear();
+
+    Dynarmic::UserCallbacks user_callbacks = GetUserCallbacks();
+    user_callbacks.page_table = &page_table;
+    return user_callbacks;
+}
+
+/// Places `instructions` at address 0 followed by a branch-to-self, then executes each of them once
+/// starting with the given CPSR (user mode by default).
+static void RunInstructions(Dynarmic::Jit& jit, const std::vector<u32>& instructions, u32 cpsr = 0x000001d0) {
+    code_mem.fill({});
+    std::copy(instructions.begin(), instructions.end(), code_mem.begin());
+    code_mem[instructions.size()] = 0xEAFFFFFE; // b +#0
+
+    jit.Cpsr() = cpsr;
+    jit.Run(instructions.size() + 1);
+}
+
 struct InstructionGenerator final {
 public:
     InstructionGenerator(const char* format, std::function<bool(u32)> is_valid = [](u32){ return true; }) : is_valid(is_valid) {
@@ -192,14 +232,16 @@ static bool DoesBehaviorMatch(const ARMul_State& interp, const Dynarmic::Jit& ji
            && interp_write_records == jit_write_records;
 }
 
-void FuzzJitArm(const size_t instruction_count, const size_t instructions_to_execute_count, const size_t run_count, const std::function<u32()> instruction_generator) {
+void FuzzJitArm(const size_t instruction_count, const size_t instructions_to_execute_count, const size_t run_count, const std::function<u32()> instruction_generator, const u32 disabled_host_features = 0) {
     // Prepare memory
     code_mem.fill(0xEAFFFFFE); // b +#0
 
     // Prepare test subjects
     ARMul_State interp{USER32MODE};
     interp.user_callbacks = GetUserCallbacks();
-    Dynarmic::Jit jit{GetUserCallbacks()};
+    Dynarmic::UserCallbacks jit_callbacks = GetUserCallbacks();
+    jit_callbacks.disabled_host_features = disabled_host_features;
+    Dynarmic::Jit jit{jit_callbacks};
 
     for (size_t run_number = 0; run_number < run_count; run_number++) {
         interp.instruction_cache.clear();
@@ -568,6 +610,10 @@ TEST_CASE("Fuzz ARM data processing instructions", "[JitX64]") {
     SECTION("R15") {
         FuzzJitArm(1, 1, 10000, instruction_select(/*Rd_can_be_r15=*/true));
     }
+
+    SECTION("without optional host features") {
+        FuzzJitArm(5, 6, 10000, instruction_select(/*Rd_can_be_r15=*/false), ~u32(0));
+    }
 }
 
 TEST_CASE("Fuzz ARM load/store instructions (byte, half-word, word)", "[JitX64]") {
@@ -923,6 +969,822 @@ TEST_CASE( "SMUAD", "[JitX64]" ) {
     REQUIRE(jit.Cpsr() == 0x080001d0);
 }
 
+TEST_CASE( "Cold block tier", "[JitX64]" ) {
+    Dynarmic::UserCallbacks cold_callbacks = GetUserCallbacks();
+    cold_callbacks.cold_block_threshold = 3;
+
+    Dynarmic::Jit jit{GetUserCallbacks()};
+    Dynarmic::Jit cold_jit{cold_callbacks};
+    code_mem.fill({});
+    code_mem[0] = 0xE0900001; // adds r0, r0, r1
+    code_mem[1] = 0xE0B33002; // adcs r3, r3, r2
+    code_mem[2] = 0xEAFFFFFC; // b +#-16
+
+    for (Dynarmic::Jit* subject : {&jit, &cold_jit}) {
+        subject->Regs() = {
+                0x7FFFFFF0, 0x12345678, 0x87654321, 0,
+                0, 0, 0, 0,
+                0, 0, 0, 0,
+                0, 0, 0, 0,
+        };
+        subject->Cpsr() = 0x000001d0; // User-mode
+    }
+
+    // The first few iterations of the loop are interpreted by cold_jit; the rest are emitted.
+    for (size_t i = 0; i < 6; i++) {
+        REQUIRE(jit.Run(3) == cold_jit.Run(3));
+        REQUIRE(jit.Regs() == cold_jit.Regs());
+        REQUIRE(jit.Cpsr() == cold_jit.Cpsr());
+    }
+}
+
+static size_t svc_call_count = 0;
+static void CountSVC(u32) {
+    svc_call_count++;
+}
+
+TEST_CASE( "SVC with an MXCSR-agnostic callback", "[JitX64]" ) {
+    Dynarmic::UserCallbacks callbacks = GetUserCallbacks();
+    callbacks.CallSVC = &CountSVC;
+    callbacks.CallSVC_is_mxcsr_agnostic = true;
+
+    Dynarmic::Jit jit{callbacks};
+    code_mem.fill({});
+    code_mem[0] = 0xE2800001; // add r0, r0, #1
+    code_mem[1] = 0xEF000000; // svc #0
+    code_mem[2] = 0xEAFFFFFC; // b +#-16
+
+    jit.Regs() = {};
+    jit.Cpsr() = 0x000001d0; // User-mode
+    jit.SetFpscr(0x03C00000); // DN, FZ, round towards zero
+
+    svc_call_count = 0;
+    const u32 host_mxcsr = _mm_getcsr();
+    jit.Run(30);
+
+    REQUIRE(svc_call_count == 10);
+    REQUIRE(jit.Regs()[0] == 10);
+    REQUIRE(jit.Fpscr() == 0x03C00000);
+    REQUIRE(_mm_getcsr() == host_mxcsr);
+}
+
+TEST_CASE( "VFP: VMSR, VMRS", "[JitX64][vfp]" ) {
+    Dynarmic::Jit jit{GetUserCallbacks()};
+    code_mem.fill({});
+    code_mem[0] = 0xEEE10A10; // vmsr fpscr, r0
+    code_mem[1] = 0xEEF11A10; // vmrs r1, fpscr
+    code_mem[2] = 0xEAFFFFFE; // b +#0
+
+    // NZCV, DN, FZ, RMode, and all cumulative exception flags
+    const u32 fpscr = 0x63C0009F;
+
+    jit.Regs() = {};
+    jit.Regs()[0] = fpscr;
+    jit.Cpsr() = 0x000001d0; // User-mode
+    jit.SetFpscr(0);
+
+    jit.Run(3);
+
+    REQUIRE(jit.Regs()[1] == fpscr);
+    REQUIRE(jit.Fpscr() == fpscr);
+}
+
+TEST_CASE( "VFP: Flush to zero with fast_fp", "[JitX64][vfp]" ) {
+    Dynarmic::UserCallbacks callbacks = GetUserCallbacks();
+    callbacks.fast_fp = true;
+
+    Dynarmic::Jit jit{callbacks};
+    code_mem.fill({});
+    code_mem[0] = 0xEE201A20; // vmul.f32 s2, s0, s1
+    code_mem[1] = 0xEAFFFFFE; // b +#0
+
+    jit.Regs() = {};
+    jit.ExtRegs() = {};
+    jit.ExtRegs()[0] = 0x1E3CE508; // 1e-20f
+    jit.ExtRegs()[1] = 0x1E3CE508; // 1e-20f
+    jit.Cpsr() = 0x000001d0; // User-mode
+    jit.SetFpscr(0x01000000); // FZ
+
+    jit.Run(2);
+
+    // The product is a denormal, which is flushed to zero.
+    REQUIRE(jit.ExtRegs()[2] == 0);
+}
+
+TEST_CASE("VFP: VCVT to integer saturates", "[JitX64][vfp]") {
+    code_mem.fill({});
+    code_mem[0] = 0xEEFD0AC0; // vcvt.s32.f32 s1, s0
+    code_mem[1] = 0xEEBC1AC0; // vcvt.u32.f32 s2, s0
+    code_mem[2] = 0xEEFC1A40; // vcvtr.u32.f32 s3, s0
+    code_mem[3] = 0xEEBD2A40; // vcvtr.s32.f32 s4, s0
+    code_mem[4] = 0xEAFFFFFE; // b +#0
+
+    struct TestCase {
+        u32 input;
+        u32 s32_rtz, u32_rtz, u32_rn, s32_rn;
+    };
+    const std::vector<TestCase> test_cases {
+        {0x40300000, 0x00000002, 0x00000002, 0x00000003, 0x00000003}, // 2.75
+        {0xBFC00000, 0xFFFFFFFF, 0x00000000, 0x00000000, 0xFFFFFFFE}, // -1.5
+        {0x4F32D05E, 0x7FFFFFFF, 0xB2D05E00, 0xB2D05E00, 0x7FFFFFFF}, // 3000000000
+        {0x60AD78EC, 0x7FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x7FFFFFFF}, // 1e20
+        {0x7FC00000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}, // NaN
+    };
+
+    for (u32 disabled_host_features : {u32(0), u32(Dynarmic::HostFeature::SSE41)}) {
+        Dynarmic::UserCallbacks callbacks = GetUserCallbacks();
+        callbacks.disabled_host_features = disabled_host_features;
+        Dynarmic::Jit jit{callbacks};
+
+        for (const auto& test_case : test_cases) {
+            jit.Regs() = {};
+            jit.ExtRegs() = {};
+            jit.ExtRegs()[0] = test_case.input;
+            jit.Cpsr() = 0x000001d0; // User-mode
+            jit.SetFpscr(0); // Round to nearest
+
+            jit.Run(5);
+
+            REQUIRE(jit.ExtRegs()[1] == test_case.s32_rtz);
+            REQUIRE(jit.ExtRegs()[2] == test_case.u32_rtz);
+            REQUIRE(jit.ExtRegs()[3] == test_case.u32_rn);
+            REQUIRE(jit.ExtRegs()[4] == test_case.s32_rn);
+        }
+    }
+}
+
+TEST_CASE("Big-endian loads and stores through the page table", "[JitX64]") {
+    for (u32 disabled_host_features : {u32(0), u32(Dynarmic::HostFeature::MOVBE)}) {
+        Dynarmic::UserCallbacks callbacks = GetUserCallbacksWithPageTable();
+        callbacks.disabled_host_features = disabled_host_features;
+        Dynarmic::Jit jit{callbacks};
+
+        mapped_memory[0] = 0x12;
+        mapped_memory[1] = 0x34;
+        mapped_memory[2] = 0x56;
+        mapped_memory[3] = 0x78;
+
+        jit.Regs() = {};
+        jit.Regs()[0] = MAPPED_VADDR;
+
+        RunInstructions(jit, {
+            0xF1010200, // setend be
+            0xE5901000, // ldr r1, [r0]
+            0xE5801004, // str r1, [r0, #4]
+        });
+
+        REQUIRE(jit.Regs()[1] == 0x12345678);
+        REQUIRE(mapped_memory[4] == 0x12);
+        REQUIRE(mapped_memory[5] == 0x34);
+        REQUIRE(mapped_memory[6] == 0x56);
+        REQUIRE(mapped_memory[7] == 0x78);
+    }
+}
+
+TEST_CASE("Block transfers through the page table", "[JitX64]") {
+    Dynarmic::Jit jit{GetUserCallbacksWithPageTable()};
+
+    jit.Regs() = {};
+    jit.Regs()[0] = MAPPED_VADDR;
+    jit.Regs()[1] = 0x11111111;
+    jit.Regs()[2] = 0x22222222;
+    jit.Regs()[3] = 0x33333333;
+    jit.Regs()[4] = 0x44444444;
+    jit.Regs()[9] = 0x20000;  // Unmapped
+    jit.Regs()[10] = 0x10FFC; // Crosses into an unmapped page
+    jit.ExtRegs() = {};
+    jit.ExtRegs()[4] = 0x55555555;
+    jit.ExtRegs()[5] = 0x66666666;
+    jit.ExtRegs()[6] = 0x77777777;
+    jit.ExtRegs()[7] = 0x88888888;
+
+    RunInstructions(jit, {
+        0xE880001E, // stmia r0, {r1-r4}
+        0xE89001E0, // ldmia r0, {r5-r8}
+        0xEC900B04, // vldmia r0, {d0-d1}
+        0xEC892A04, // vstmia r9, {s4-s7}
+        0xE89A1800, // ldmia r10, {r11, r12}
+    });
+
+    for (size_t i = 0; i < 4; i++) {
+        u32 word;
+        std::memcpy(&word, mapped_memory.data() + 4 * i, sizeof(u32));
+        REQUIRE(word == jit.Regs()[1 + i]);
+        REQUIRE(jit.Regs()[5 + i] == jit.Regs()[1 + i]);
+        REQUIRE(jit.ExtRegs()[i] == jit.Regs()[1 + i]);
+    }
+
+    const std::vector<WriteRecord> expected_writes {
+        {32, 0x20000, 0x55555555},
+        {32, 0x20004, 0x66666666},
+        {32, 0x20008, 0x77777777},
+        {32, 0x2000C, 0x88888888},
+    };
+    REQUIRE(write_records == expected_writes);
+
+    // Accesses that cannot be performed with a single page lookup go through the callbacks.
+    REQUIRE(jit.Regs()[11] == 0x10FFC);
+    REQUIRE(jit.Regs()[12] == 0x11000);
+}
+
+TEST_CASE("Exclusive stores and swaps through the page table", "[JitX64]") {
+    Dynarmic::Jit jit{GetUserCallbacksWithPageTable()};
+
+    const u32 initial_word = 0x12345678;
+    std::memcpy(mapped_memory.data(), &initial_word, sizeof(u32));
+
+    jit.Regs() = {};
+    jit.Regs()[0] = MAPPED_VADDR;
+    jit.Regs()[3] = 0xAAAAAAAA;
+    jit.Regs()[6] = 0xBBBBBBBB;
+    jit.Regs()[8] = 0xCC;
+    jit.Regs()[9] = 0x20001; // Unmapped
+
+    RunInstructions(jit, {
+        0xE1901F9F, // ldrex r1, [r0]
+        0xE1802F93, // strex r2, r3, [r0]
+        0xE1804F93, // strex r4, r3, [r0]
+        0xE1005096, // swp r5, r6, [r0]
+        0xE1497098, // swpb r7, r8, [r9]
+    });
+
+    REQUIRE(jit.Regs()[1] == 0x12345678);
+    REQUIRE(jit.Regs()[2] == 0); // Passed
+    REQUIRE(jit.Regs()[4] == 1); // Failed: the first strex cleared the monitor
+    REQUIRE(jit.Regs()[5] == 0xAAAAAAAA);
+
+    u32 final_word;
+    std::memcpy(&final_word, mapped_memory.data(), sizeof(u32));
+    REQUIRE(final_word == 0xBBBBBBBB);
+
+    // The callbacks are used for unmapped pages.
+    REQUIRE(jit.Regs()[7] == 0x01);
+    const std::vector<WriteRecord> expected_writes {{8, 0x20001, 0xCC}};
+    REQUIRE(write_records == expected_writes);
+}
+
+TEST_CASE("Accesses straddling a page boundary use the callbacks", "[JitX64]") {
+    Dynarmic::Jit jit{GetUserCallbacksWithPageTable(2)};
+
+    for (size_t i = 0; i < 4096; i++) {
+        mapped_memory[i] = static_cast<u8>(i);
+        mapped_memory[4096 + i] = 0xFF;
+    }
+
+    jit.Regs() = {};
+    jit.Regs()[0] = 0x10FFE; // Straddles both pages
+    jit.Regs()[2] = 0xDEADBEEF;
+    jit.Regs()[3] = 0x10001; // Unaligned, but within a page
+
+    RunInstructions(jit, {
+        0xE5901000, // ldr r1, [r0]
+        0xE5802000, // str r2, [r0]
+        0xE5934000, // ldr r4, [r3]
+    });
+
+    REQUIRE(jit.Regs()[1] == 0x10FFE);
+    const std::vector<WriteRecord> expected_writes {{32, 0x10FFE, 0xDEADBEEF}};
+    REQUIRE(write_records == expected_writes);
+    REQUIRE(mapped_memory[4094] == 0xFE);
+    REQUIRE(mapped_memory[4095] == 0xFF);
+    REQUIRE(mapped_memory[4096] == 0xFF);
+    REQUIRE(jit.Regs()[4] == 0x04030201);
+}
+
+TEST_CASE("Sparse page table with 16K pages", "[JitX64]") {
+    constexpr size_t page_bits = 14;
+    static std::array<u8, 1 << page_bits> data_page;
+    static std::array<u8*, 1 << (Dynarmic::UserCallbacks::PAGE_DIRECTORY_SHIFT - page_bits)> second_level;
+    static std::array<u8**, Dynarmic::UserCallbacks::NUM_PAGE_DIRECTORY_ENTRIES> page_directory;
+    second_level.fill(nullptr);
+    second_level[(0x10000 >> page_bits) % second_level.size()] = data_page.data();
+    page_directory.fill(nullptr);
+    page_directory[0x10000 >> Dynarmic::UserCallbacks::PAGE_DIRECTORY_SHIFT] = second_level.data();
+
+    data_page.fill(0);
+    write_records.clear();
+
+    Dynarmic::UserCallbacks callbacks = GetUserCallbacks();
+    callbacks.page_directory = &page_directory;
+    callbacks.page_bits = page_bits;
+    Dynarmic::Jit jit{callbacks};
+
+    jit.Regs() = {};
+    jit.Regs()[0] = 0x10002;     // Straddles a 4K boundary, but not a 16K one
+    jit.Regs()[1] = 0xCAFEBABE;
+    jit.Regs()[3] = 0x13FFE;     // Straddles a 16K boundary
+    jit.Regs()[5] = 0x20000000;  // No second-level table
+
+    RunInstructions(jit, {
+        0xE5801FFC, // str r1, [r0, #0xFFC]
+        0xE5902FFC, // ldr r2, [r0, #0xFFC]
+        0xE5934000, // ldr r4, [r3]
+        0xE5956000, // ldr r6, [r5]
+    });
+
+    u32 word;
+    std::memcpy(&word, data_page.data() + 0xFFE, sizeof(u32));
+    REQUIRE(word == 0xCAFEBABE);
+    REQUIRE(write_records.empty());
+    REQUIRE(jit.Regs()[2] == 0xCAFEBABE);
+    REQUIRE(jit.Regs()[4] == 0x13FFE);
+    REQUIRE(jit.Regs()[6] == 0x20000000);
+}
+
+TEST_CASE("Page table accesses under high register pressure", "[JitX64]") {
+    // Every loaded value is live until the stores, so all allocatable host registers are in use
+    // alongside the scratch registers of the page table lookups.
+    const std::vector<u32> guest_regs {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 14};
+    std::vector<u32> instructions;
+    for (u32 i = 0; i < guest_regs.size(); i++) {
+        instructions.push_back(0xE5900000 | guest_regs[i] << 12 | i * 4);           // ldr rN, [r0, #i*4]
+    }
+    for (u32 i = 0; i < guest_regs.size(); i++) {
+        instructions.push_back(0xE5800000 | guest_regs[i] << 12 | (0x100 + i * 4)); // str rN, [r0, #0x100+i*4]
+    }
+
+    SECTION("With a page table, R14 is reserved") {
+        Dynarmic::Jit jit{GetUserCallbacksWithPageTable()};
+        for (u32 i = 0; i < guest_regs.size(); i++) {
+            const u32 value = 0x01010101 * (i + 1);
+            std::memcpy(mapped_memory.data() + i * 4, &value, sizeof(u32));
+        }
+
+        jit.Regs() = {};
+        jit.Regs()[0] = MAPPED_VADDR;
+        RunInstructions(jit, instructions);
+
+        for (u32 i = 0; i < guest_regs.size(); i++) {
+            u32 word;
+            std::memcpy(&word, mapped_memory.data() + 0x100 + i * 4, sizeof(u32));
+            REQUIRE(jit.Regs()[guest_regs[i]] == 0x01010101 * (i + 1));
+            REQUIRE(word == 0x01010101 * (i + 1));
+        }
+        REQUIRE(write_records.empty());
+    }
+
+    SECTION("Without a page table, R14 is allocatable") {
+        Dynarmic::Jit jit{GetUserCallbacks()};
+        write_records.clear();
+
+        jit.Regs() = {};
+        jit.Regs()[0] = MAPPED_VADDR;
+        RunInstructions(jit, instructions);
+
+        std::vector<WriteRecord> expected_writes;
+        for (u32 i = 0; i < guest_regs.size(); i++) {
+            // MemoryRead32 returns the address read from.
+            REQUIRE(jit.Regs()[guest_regs[i]] == MAPPED_VADDR + i * 4);
+            expected_writes.push_back({32, MAPPED_VADDR + 0x100 + i * 4, MAPPED_VADDR + i * 4});
+        }
+        REQUIRE(write_records == expected_writes);
+    }
+}
+
+TEST_CASE("Mode switches bank R8-R14 and SPSR", "[JitX64]") {
+    Dynarmic::Jit jit{GetUserCallbacks()};
+
+    jit.Regs() = {};
+    jit.Regs()[0] = 0x800001d0;
+    jit.Regs()[1] = 0x400001d0;
+    jit.Regs()[2] = 0x200001d0;
+    for (size_t i = 8; i <= 14; i++) {
+        jit.Regs()[i] = 0x100 + i;
+    }
+
+    RunInstructions(jit, {
+        0xE16FF000, // msr spsr_fsxc, r0
+        0xF1020011, // cps #17 (FIQ)
+        0xE3A08088, // mov r8, #0x88
+        0xE3A09099, // mov r9, #0x99
+        0xE3A0A0AA, // mov r10, #0xAA
+        0xE3A0B0BB, // mov r11, #0xBB
+        0xE3A0C0CC, // mov r12, #0xCC
+        0xE3A0D0DD, // mov sp, #0xDD
+        0xE3A0E0EE, // mov lr, #0xEE
+        0xE16FF001, // msr spsr_fsxc, r1
+        0xE321F0D2, // msr cpsr_c, #0xD2 (IRQ)
+        0xE3A0D01D, // mov sp, #0x1D
+        0xE3A0E01E, // mov lr, #0x1E
+        0xE16FF002, // msr spsr_fsxc, r2
+        0xF102001F, // cps #31 (System)
+        0xE3A08028, // mov r8, #0x28
+        0xE3A0D02D, // mov sp, #0x2D
+        0xE3A0E02E, // mov lr, #0x2E
+        0xF1020013, // cps #19 (Supervisor)
+    }, 0x000001d3); // Supervisor-mode
+
+    // R8-R12 are shared by all modes other than FIQ mode.
+    REQUIRE(jit.Cpsr() == 0x000001d3);
+    REQUIRE(jit.Regs()[8] == 0x28);
+    for (size_t i = 9; i <= 14; i++) {
+        REQUIRE(jit.Regs()[i] == 0x100 + i);
+    }
+    REQUIRE(jit.Spsr() == 0x800001d0);
+
+    jit.SetCpsrWithModeSwitch(0x000001d1); // FIQ-mode
+    REQUIRE(jit.Regs()[8] == 0x88);
+    REQUIRE(jit.Regs()[9] == 0x99);
+    REQUIRE(jit.Regs()[10] == 0xAA);
+    REQUIRE(jit.Regs()[11] == 0xBB);
+    REQUIRE(jit.Regs()[12] == 0xCC);
+    REQUIRE(jit.Regs()[13] == 0xDD);
+    REQUIRE(jit.Regs()[14] == 0xEE);
+    REQUIRE(jit.Spsr() == 0x400001d0);
+
+    jit.SetCpsrWithModeSwitch(0x000001d2); // IRQ-mode
+    REQUIRE(jit.Regs()[8] == 0x28);
+    for (size_t i = 9; i <= 12; i++) {
+        REQUIRE(jit.Regs()[i] == 0x100 + i);
+    }
+    REQUIRE(jit.Regs()[13] == 0x1D);
+    REQUIRE(jit.Regs()[14] == 0x1E);
+    REQUIRE(jit.Spsr() == 0x200001d0);
+
+    jit.SetCpsrWithModeSwitch(0x000001df); // System-mode
+    REQUIRE(jit.Regs()[13] == 0x2D);
+    REQUIRE(jit.Regs()[14] == 0x2E);
+}
+
+TEST_CASE("User mode cannot change the processor mode", "[JitX64]") {
+    Dynarmic::Jit jit{GetUserCallbacks()};
+
+    jit.Regs() = {};
+    jit.Regs()[0] = 0xF00001d3;
+    jit.Regs()[13] = 0x1234;
+
+    RunInstructions(jit, {
+        0xE12FF000, // msr cpsr_fsxc, r0
+        0xE321F0D3, // msr cpsr_c, #0xD3
+        0xF1020013, // cps #19
+    });
+
+    // Only the flags are written.
+    REQUIRE(jit.Cpsr() == 0xF00001d0);
+    REQUIRE(jit.Regs()[13] == 0x1234);
+}
+
+TEST_CASE("Exception returns", "[JitX64]") {
+    Dynarmic::Jit jit{GetUserCallbacksWithPageTable()};
+
+    jit.Regs() = {};
+
+    SECTION("SRS and RFE") {
+        jit.Regs()[1] = 0x600001d0;
+        jit.Regs()[13] = MAPPED_VADDR + 0x100;
+        jit.Regs()[14] = 12;
+
+        RunInstructions(jit, {
+            0xE16FF001, // msr spsr_fsxc, r1
+            0xF96D0513, // srsdb sp!, #19
+            0xF8BD0A00, // rfeia sp!
+        }, 0x000001d3); // Supervisor-mode
+
+        u32 saved_lr, saved_spsr;
+        std::memcpy(&saved_lr, mapped_memory.data() + 0xF8, sizeof(u32));
+        std::memcpy(&saved_spsr, mapped_memory.data() + 0xFC, sizeof(u32));
+        REQUIRE(saved_lr == 12);
+        REQUIRE(saved_spsr == 0x600001d0);
+
+        REQUIRE(jit.Regs()[15] == 12);
+        REQUIRE(jit.Cpsr() == 0x600001d0);
+
+        jit.SetCpsrWithModeSwitch(0x000001d3);
+        REQUIRE(jit.Regs()[13] == MAPPED_VADDR + 0x100);
+    }
+
+    SECTION("LDM and STM of user mode registers") {
+        const u32 user_regs[] = {0xAAAAAAAA, 0xBBBBBBBB};
+        std::memcpy(mapped_memory.data() + 8, user_regs, sizeof(user_regs));
+
+        jit.Regs()[0] = MAPPED_VADDR;
+        jit.Regs()[13] = 0x5D;
+        jit.Regs()[14] = 0x5E;
+
+        RunInstructions(jit, {
+            0xF102001F, // cps #31 (System)
+            0xE3A0D02D, // mov sp, #0x2D
+            0xE3A0E02E, // mov lr, #0x2E
+            0xF1020013, // cps #19 (Supervisor)
+            0xE8C06000, // stmia r0, {sp, lr}^
+            0xE2801008, // add r1, r0, #8
+            0xE8D16000, // ldmia r1, {sp, lr}^
+        }, 0x000001d3); // Supervisor-mode
+
+        u32 stored_regs[2];
+        std::memcpy(stored_regs, mapped_memory.data(), sizeof(stored_regs));
+        REQUIRE(stored_regs[0] == 0x2D);
+        REQUIRE(stored_regs[1] == 0x2E);
+
+        // The registers of the current mode are not affected.
+        REQUIRE(jit.Cpsr() == 0x000001d3);
+        REQUIRE(jit.Regs()[13] == 0x5D);
+        REQUIRE(jit.Regs()[14] == 0x5E);
+
+        jit.SetCpsrWithModeSwitch(0x000001d0);
+        REQUIRE(jit.Regs()[13] == 0xAAAAAAAA);
+        REQUIRE(jit.Regs()[14] == 0xBBBBBBBB);
+    }
+
+    SECTION("LDM with PC restores the T bit") {
+        const u32 words[] = {0xCAFEBABE, 8};
+        std::memcpy(mapped_memory.data(), words, sizeof(words));
+
+        jit.Regs()[0] = MAPPED_VADDR;
+        jit.Regs()[1] = 0x000001F0; // User-mode, Thumb
+
+        RunInstructions(jit, {
+            0xE16FF001, // msr spsr_fsxc, r1
+            0xE8F08004, // ldmia r0!, {r2, pc}^
+            0xE7FEE7FE, // (Thumb) b +#0
+        }, 0x000001d3); // Supervisor-mode
+
+        REQUIRE(jit.Regs()[0] == MAPPED_VADDR + 8);
+        REQUIRE(jit.Regs()[2] == 0xCAFEBABE);
+        REQUIRE(jit.Regs()[15] == 8);
+        REQUIRE(jit.Cpsr() == 0x000001F0);
+    }
+
+    SECTION("SUBS PC, LR") {
+        jit.Regs()[1] = 0x600001d0;
+        jit.Regs()[14] = 12;
+
+        RunInstructions(jit, {
+            0xE16FF001, // msr spsr_fsxc, r1
+            0xE25EF004, // subs pc, lr, #4
+        }, 0x000001d3); // Supervisor-mode
+
+        REQUIRE(jit.Regs()[15] == 8);
+        REQUIRE(jit.Cpsr() == 0x600001d0);
+        REQUIRE(jit.Regs()[14] == 0); // User mode LR
+
+        jit.SetCpsrWithModeSwitch(0x000001d3);
+        REQUIRE(jit.Regs()[14] == 12);
+    }
+}
+
+#ifndef _WIN32
+TEST_CASE("Exceptions thrown by callbacks unwind through JIT code", "[JitX64]") {
+    struct CallbackException {};
+
+    SECTION("From CallSVC, called directly from a block") {
+        Dynarmic::UserCallbacks callbacks = GetUserCallbacks();
+        callbacks.CallSVC = [](u32) { throw CallbackException{}; };
+        Dynarmic::Jit jit{callbacks};
+
+        jit.Regs() = {};
+        jit.SetFpscr(0x03C00000); // DN, FZ, round towards zero
+        const u32 host_mxcsr = _mm_getcsr();
+        REQUIRE_THROWS_AS(RunInstructions(jit, {
+            0xEF000000, // svc #0
+        }), CallbackException);
+        REQUIRE(_mm_getcsr() == host_mxcsr);
+
+        // The JIT remains usable.
+        jit.Regs()[15] = 4;
+        REQUIRE(jit.Run(1) == 1);
+    }
+
+    SECTION("From MemoryRead32, called through a memory accessor") {
+        Dynarmic::UserCallbacks callbacks = GetUserCallbacksWithPageTable();
+        callbacks.MemoryRead32 = [](u32 vaddr) {
+            // Instruction fetches are also made through MemoryRead32.
+            if (vaddr == 0x20000)
+                throw CallbackException{};
+            return MemoryRead32(vaddr);
+        };
+        Dynarmic::Jit jit{callbacks};
+
+        jit.Regs() = {};
+        jit.Regs()[0] = 0x20000; // Unmapped
+        jit.SetFpscr(0x03C00000); // DN, FZ, round towards zero
+        const u32 host_mxcsr = _mm_getcsr();
+        REQUIRE_THROWS_AS(RunInstructions(jit, {
+            0xE5901000, // ldr r1, [r0]
+        }), CallbackException);
+
+        // The memory accessors call MemoryRead32 with the guest MXCSR in effect.
+        REQUIRE(_mm_getcsr() == host_mxcsr);
+
+        jit.Regs()[15] = 4;
+        REQUIRE(jit.Run(1) == 1);
+    }
+}
+#endif
+
+TEST_CASE("Indirect branches with more targets than the inline cache", "[JitX64]") {
+    // The jump table is visited in the order 0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 1, ...: target 0 mostly hits in
+    // the cache of the dispatching block, while the other five targets keep missing and replacing its entries.
+    code_mem.fill({});
+    const std::vector<u32> code {
+        0xE791F100, // dispatch: ldr pc, [r1, r0, lsl #2]
+        0xE2822001, // t0:       add r2, r2, #1
+        0xE2844001, //           add r4, r4, #1
+        0xE3540006, //           cmp r4, #6
+        0xA3A04001, //           movge r4, #1
+        0xE1A00004, //           mov r0, r4
+        0xE2555001, //           subs r5, r5, #1
+        0x1AFFFFF7, //           bne dispatch
+        0xEAFFFFFE, //           b +#0
+        0xE2622001, // t1:       rsb r2, r2, #1
+        0xE3A00000, //           mov r0, #0
+        0xEAFFFFF3, //           b dispatch
+        0xE2622002, // t2:       rsb r2, r2, #2
+        0xE3A00000, //           mov r0, #0
+        0xEAFFFFF0, //           b dispatch
+        0xE2622003, // t3:       rsb r2, r2, #3
+        0xE3A00000, //           mov r0, #0
+        0xEAFFFFED, //           b dispatch
+        0xE2622004, // t4:       rsb r2, r2, #4
+        0xE3A00000, //           mov r0, #0
+        0xEAFFFFEA, //           b dispatch
+        0xE2622005, // t5:       rsb r2, r2, #5
+        0xE3A00000, //           mov r0, #0
+        0xEAFFFFE7, //           b dispatch
+    };
+    const std::vector<u32> jump_table {0x04, 0x24, 0x30, 0x3C, 0x48, 0x54};
+    std::copy(code.begin(), code.end(), code_mem.begin());
+    std::copy(jump_table.begin(), jump_table.end(), code_mem.begin() + 0x40);
+
+    std::array<u32, 16> initial_regs{};
+    initial_regs[1] = 0x100; // Jump table
+    initial_regs[5] = 40;    // Visits of target 0
+
+    // Enough cycles to finish the loop; afterwards both spin at the branch-to-self.
+    constexpr unsigned cycles = 1000;
+
+    ARMul_State interp{USER32MODE};
+    interp.user_callbacks = GetUserCallbacks();
+    interp.instruction_cache.clear();
+    InterpreterClearCache();
+    interp.Reg = initial_regs;
+    interp.Cpsr = 0x000001d0; // User-mode
+    interp.NumInstrsToExecute = cycles;
+    InterpreterMainLoop(&interp);
+    interp.Reg[15] &= 0xFFFFFFFC;
+
+    Dynarmic::Jit jit{GetUserCallbacks()};
+    jit.Regs() = initial_regs;
+    jit.Cpsr() = 0x000001d0; // User-mode
+    jit.Run(cycles);
+
+    REQUIRE(jit.Regs()[15] == 0x20);
+    REQUIRE(jit.Regs()[5] == 0);
+    REQUIRE(interp.Reg == jit.Regs());
+    REQUIRE(interp.Cpsr == jit.Cpsr());
+}
+
+TEST_CASE("Block profile", "[JitX64]") {
+    Dynarmic::UserCallbacks callbacks = GetUserCallbacks();
+    callbacks.enable_block_profiling = true;
+
+    Dynarmic::Jit jit{callbacks};
+    code_mem.fill({});
+    code_mem[0] = 0xE2800001; // add r0, r0, #1
+    code_mem[1] = 0xE3500003; // cmp r0, #3
+    code_mem[2] = 0x1AFFFFFC; // bne +#-16
+    code_mem[3] = 0xE2811001; // add r1, r1, #1
+    code_mem[4] = 0xE3A00000; // mov r0, #0
+    code_mem[5] = 0xEAFFFFF9; // b +#-28
+
+    jit.Regs() = {};
+    jit.Cpsr() = 0x000001d0; // User-mode
+    jit.Run(60);
+
+    const auto profile = jit.GetBlockProfile();
+    REQUIRE(profile.size() == 2);
+    REQUIRE(profile[0].pc == 0);
+    REQUIRE(profile[1].pc == 12);
+    // The block at 12 is entered once every three iterations of the loop at 0.
+    REQUIRE(profile[0].execution_count >= 3 * profile[1].execution_count);
+    REQUIRE(profile[1].execution_count >= 1);
+    for (const auto& entry : profile) {
+        REQUIRE(entry.host_code_size > 0);
+        REQUIRE(entry.ir_instruction_count > 0);
+    }
+
+    Dynarmic::Jit unprofiled_jit{GetUserCallbacks()};
+    unprofiled_jit.Regs() = {};
+    unprofiled_jit.Cpsr() = 0x000001d0; // User-mode
+    unprofiled_jit.Run(60);
+    REQUIRE(unprofiled_jit.GetBlockProfile().empty());
+}
+
+#ifdef __linux__
+TEST_CASE("Perf map", "[JitX64]") {
+    Dynarmic::UserCallbacks callbacks = GetUserCallbacks();
+    callbacks.enable_perf_map = true;
+    callbacks.enable_block_profiling = true;
+
+    Dynarmic::Jit jit{callbacks};
+    code_mem.fill({});
+    code_mem[0] = 0xE2800001; // add r0, r0, #1
+    code_mem[1] = 0xEAFFFFFD; // b +#-12
+
+    jit.Regs() = {};
+    jit.Cpsr() = 0x000001d0; // User-mode
+    jit.Run(10);
+
+    const auto profile = jit.GetBlockProfile();
+    REQUIRE(profile.size() == 1);
+
+    const std::string filename = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+    std::FILE* file = std::fopen(filename.c_str(), "r");
+    REQUIRE(file != nullptr);
+
+    // Each line is of the form: <start address> <size> <symbol name>, with numbers in hexadecimal.
+    bool found = false;
+    char line[256];
+    while (std::fgets(line, sizeof(line), file)) {
+        u64 start;
+        size_t size;
+        char name[128];
+        if (std::sscanf(line, "%" SCNx64 " %zx %127s", &start, &size, name) != 3)
+            continue;
+        if (std::strncmp(name, "dynarmic_arm_00000000_", 22) == 0) {
+            found = start != 0 && size == profile[0].host_code_size;
+        }
+    }
+    std::fclose(file);
+    std::remove(filename.c_str());
+
+    REQUIRE(found);
+}
+#endif
+
+TEST_CASE("Statistics", "[JitX64]") {
+    Dynarmic::Jit jit{GetUserCallbacks()};
+    code_mem.fill({});
+    code_mem[0] = 0xE2800001; // add r0, r0, #1
+    code_mem[1] = 0xE6813072; // sxtab16 r3, r1, r2
+    code_mem[2] = 0xEAFFFFFC; // b +#-16
+
+    jit.Regs() = {};
+    jit.Cpsr() = 0x000001d0; // User-mode
+    jit.Run(30);
+
+    const auto statistics = jit.GetStatistics();
+    REQUIRE(statistics.blocks_translated >= 1);
+    REQUIRE(statistics.blocks_compiled == statistics.blocks_translated);
+    REQUIRE(statistics.guest_instructions_translated >= 3);
+    REQUIRE(statistics.host_code_bytes_emitted > 0);
+    REQUIRE(statistics.code_cache_used > 0);
+    REQUIRE(statistics.code_cache_used <= statistics.code_cache_size);
+    REQUIRE(statistics.interpreter_fallbacks.at("SXTAB16") == statistics.blocks_translated);
+    REQUIRE(statistics.dispatcher_entries >= 1);
+    REQUIRE(statistics.dispatcher_exits < statistics.dispatcher_entries);
+
+    REQUIRE(statistics.stages.size() == 5);
+    REQUIRE(statistics.stages.front().name == "Translate");
+    REQUIRE(statistics.stages.back().name == "Emit");
+    for (size_t i = 1; i < statistics.stages.size(); i++) {
+        REQUIRE(statistics.stages[i].ir_instructions_before == statistics.stages[i - 1].ir_instructions_after);
+    }
+}
+
+TEST_CASE("Return stack buffer", "[JitX64]") {
+    // main calls f_1, and each f_k calls f_(k+1) up to f_depth, so that every return has a distinct target.
+    constexpr size_t depth = 12;
+    const auto bl = [](u32 from, u32 to) -> u32 {
+        return 0xEB000000 | (((to - from - 8) >> 2) & 0xFFFFFF);
+    };
+    const auto function_address = [](size_t k) -> u32 {
+        return static_cast<u32>(8 + (k - 1) * 16);
+    };
+
+    code_mem.fill({});
+    code_mem[0] = bl(0, function_address(1));
+    code_mem[1] = 0xEAFFFFFE; // b +#0
+    for (size_t k = 1; k <= depth; k++) {
+        const u32 address = function_address(k);
+        code_mem[address / 4 + 0] = 0xE92D4000; // stmdb sp!, {lr}
+        code_mem[address / 4 + 1] = k < depth ? bl(address + 4, function_address(k + 1))
+                                              : 0xE2811001; // add r1, r1, #1
+        code_mem[address / 4 + 2] = 0xE8BD4000; // ldmia sp!, {lr}
+        code_mem[address / 4 + 3] = 0xE12FFF1E; // bx lr
+    }
+
+    for (size_t rsb_size : {size_t(4), size_t(16)}) {
+        Dynarmic::UserCallbacks callbacks = GetUserCallbacksWithPageTable();
+        callbacks.rsb_size = rsb_size;
+        Dynarmic::Jit jit{callbacks};
+
+        jit.Regs() = {};
+        jit.Regs()[13] = MAPPED_VADDR + 0x1000;
+        jit.Cpsr() = 0x000001d0; // User-mode
+        jit.Run(200);
+
+        REQUIRE(jit.Regs()[1] == 1);
+        REQUIRE(jit.Regs()[13] == MAPPED_VADDR + 0x1000);
+        REQUIRE(jit.Regs()[15] == 4);
+
+        // Only the innermost rsb_size returns are predicted once the stack has wrapped around.
+        const auto statistics = jit.GetStatistics();
+        REQUIRE(statistics.rsb_hits == std::min(rsb_size, depth));
+        REQUIRE(statistics.rsb_misses == depth - std::min(rsb_size, depth));
+    }
+}
+
 TEST_CASE("VFP: VPUSH, VPOP", "[JitX64][vfp]") {
     const auto is_valid = [](u32 instr) -> bool {
         auto regs = (instr & 0x100) ? (Bits<0, 7>(instr) >> 1) : Bits<0, 7>(instr);
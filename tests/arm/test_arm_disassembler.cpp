@@ -376,3 +376,22 @@ TEST_CASE("Disassemble synchronization primitive instructions", "[arm][disassemb
     REQUIRE(DisassembleArm(0xE1031092) == "swp r1, r2, [r3]");
     REQUIRE(DisassembleArm(0xE1431092) == "swpb r1, r2, [r3]");
 }
+
+TEST_CASE("Disassemble status register access instructions", "[arm][disassembler]") {
+    REQUIRE(DisassembleArm(0xF10C0080) == "cpsid i");
+    REQUIRE(DisassembleArm(0xF10A00D3) == "cpsie if, #19");
+    REQUIRE(DisassembleArm(0xF1020013) == "cps #19");
+
+    REQUIRE(DisassembleArm(0xE10F1000) == "mrs r1, apsr");
+    REQUIRE(DisassembleArm(0xE14F0000) == "mrs r0, spsr");
+    REQUIRE(DisassembleArm(0xE328F4F0) == "msr apsr_nzcvq, #4026531840");
+    REQUIRE(DisassembleArm(0xE121F000) == "msr cpsr_c, r0");
+    REQUIRE(DisassembleArm(0xE16FF001) == "msr spsr_fsxc, r1");
+
+    REQUIRE(DisassembleArm(0xF8BD0A00) == "rfeia sp!");
+    REQUIRE(DisassembleArm(0xF96D0513) == "srsdb sp!, #19");
+
+    REQUIRE(DisassembleArm(0xE8FD8001) == "ldmia sp!, {r0, pc}^");
+    REQUIRE(DisassembleArm(0xE8DD4001) == "ldmia sp, {r0, lr}^");
+    REQUIRE(DisassembleArm(0xE8CD4001) == "stmia sp, {r0, lr}^");
+}
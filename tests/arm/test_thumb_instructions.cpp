@@ -169,3 +169,23 @@ TEST_CASE( "thumb: bl -#42", "[thumb]" ) {
     REQUIRE( jit.Regs()[15] == 0xFFFFFFD6 );
     REQUIRE( jit.Cpsr() == 0x00000030 ); // Thumb, User-mode
 }
+
+TEST_CASE( "thumb: Unimplemented instructions are interpreted in-block", "[thumb]" ) {
+    Dynarmic::Jit jit{GetUserCallbacks()};
+    code_mem.fill({});
+    code_mem[0] = 0x4348; // muls r0, r1, r0 (interpreted)
+    code_mem[1] = 0x0040; // lsls r0, r0, #1
+    code_mem[2] = 0xE7FE; // b +#0
+
+    jit.Regs()[0] = 3;
+    jit.Regs()[1] = 5;
+    jit.Regs()[15] = 0; // PC = 0
+    jit.Cpsr() = 0x00000030; // Thumb, User-mode
+
+    jit.Run(2);
+
+    REQUIRE( jit.Regs()[0] == 30 );
+    REQUIRE( jit.Regs()[1] == 5 );
+    REQUIRE( jit.Regs()[15] == 4 );
+    REQUIRE( jit.Cpsr() == 0x00000030 ); // Thumb, User-mode
+}